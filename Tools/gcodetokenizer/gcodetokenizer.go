@@ -0,0 +1,168 @@
+package main
+
+// Convert a G-code print file to the tokenized format that RepRapFirmware can execute without parsing the text of G0/G1/G2/G3 commands.
+// Usage: gcodetokenizer input.gcode output.gcode
+//
+// The output starts with the line in tokenizedFileMagic. Each G0/G1/G2/G3 command that can be tokenized is replaced by
+// a tag byte, the command number, a 32-bit bitmap of the parameter letters present and a 32-bit float for each parameter
+// in alphabetical order, all little-endian. Every other line is copied unchanged. The format is defined in src/GCodes/GCodeInput.h.
+
+import (
+	"bufio"
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"math"
+	"os"
+	"strconv"
+)
+
+const tokenizedFileMagic = ";RRF tokenized G-code v1\n"
+const tokenizedMoveTag = 0x01
+
+// Try to tokenize a line. Return nil if it must be left as text.
+func tokenize(line []byte) []byte {
+	// The command must start at the beginning of the line and be G0, G1, G2 or G3 with no fraction
+	if len(line) < 2 || line[0] != 'G' {
+		return nil
+	}
+	i := 1
+	for i < len(line) && line[i] == '0' {
+		i++
+	}
+	code := 0
+	if i < len(line) && line[i] >= '1' && line[i] <= '3' {
+		code = int(line[i] - '0')
+		i++
+	} else if i == 1 {
+		return nil
+	}
+	if i < len(line) && line[i] != ' ' && line[i] != '\t' && line[i] != ';' {
+		return nil
+	}
+
+	var letters uint32
+	var values [26]float32
+	for i < len(line) {
+		c := line[i]
+		if c == ' ' || c == '\t' {
+			i++
+			continue
+		}
+		if c == ';' {
+			break // the rest of the line is a comment, which we drop
+		}
+
+		// Only accept upper case parameter letters followed immediately by a plain decimal number.
+		// Other command letters, expressions, quoted strings etc. must be left for the string parser.
+		if c < 'A' || c > 'Z' || c == 'G' || c == 'M' || c == 'N' || c == 'T' {
+			return nil
+		}
+		bit := uint32(1) << (c - 'A')
+		if letters&bit != 0 {
+			return nil
+		}
+		i++
+		start := i
+		if i < len(line) && line[i] == '-' {
+			i++
+		}
+		digits := 0
+		for i < len(line) && line[i] >= '0' && line[i] <= '9' {
+			i++
+			digits++
+		}
+		if i < len(line) && line[i] == '.' {
+			i++
+			for i < len(line) && line[i] >= '0' && line[i] <= '9' {
+				i++
+				digits++
+			}
+		}
+		if digits == 0 || (i < len(line) && line[i] != ' ' && line[i] != '\t' && line[i] != ';') {
+			return nil
+		}
+		v, err := strconv.ParseFloat(string(line[start:i]), 32)
+		if err != nil {
+			return nil
+		}
+		letters |= bit
+		values[c-'A'] = float32(v)
+	}
+
+	// Keep moves that change Z as text, because the firmware looks for them when it works out the layer height and object height
+	if letters&(uint32(1)<<('Z'-'A')) != 0 {
+		return nil
+	}
+
+	out := []byte{tokenizedMoveTag, byte(code), 0, 0, 0, 0}
+	binary.LittleEndian.PutUint32(out[2:], letters)
+	for n := 0; n < 26; n++ {
+		if letters&(uint32(1)<<uint(n)) != 0 {
+			var b [4]byte
+			binary.LittleEndian.PutUint32(b[:], math.Float32bits(values[n]))
+			out = append(out, b[:]...)
+		}
+	}
+	return out
+}
+
+func main() {
+	if len(os.Args) != 3 {
+		fmt.Fprintln(os.Stderr, "Usage: gcodetokenizer input.gcode output.gcode")
+		os.Exit(1)
+	}
+
+	in, err := os.ReadFile(os.Args[1])
+	if err != nil {
+		panic(err)
+	}
+	if bytes.HasPrefix(in, []byte(tokenizedFileMagic)) {
+		fmt.Fprintln(os.Stderr, "Input file is already tokenized")
+		os.Exit(1)
+	}
+
+	f, err := os.Create(os.Args[2])
+	if err != nil {
+		panic(err)
+	}
+	defer f.Close()
+	w := bufio.NewWriter(f)
+	w.WriteString(tokenizedFileMagic)
+
+	// After an indented line we must not emit a tokenized move until a text command at the outer level has been written,
+	// because the firmware needs to see that line to end a conditional block or loop
+	inBlock := false
+	textLines, tokenizedLines := 0, 0
+	lines := bytes.SplitAfter(in, []byte("\n"))
+	for _, line := range lines {
+		if len(line) == 0 {
+			continue
+		}
+		trimmed := bytes.TrimRight(line, "\r\n")
+		if !inBlock {
+			if tok := tokenize(trimmed); tok != nil {
+				w.Write(tok)
+				tokenizedLines++
+				continue
+			}
+		}
+		if len(trimmed) != 0 {
+			if trimmed[0] == ' ' || trimmed[0] == '\t' {
+				inBlock = true
+			} else if trimmed[0] != ';' {
+				inBlock = false
+			}
+		}
+		w.Write(line)
+		if line[len(line)-1] != '\n' {
+			w.WriteString("\n") // a tokenized move may follow, so the last text line must be terminated
+		}
+		textLines++
+	}
+
+	if err = w.Flush(); err != nil {
+		panic(err)
+	}
+	fmt.Printf("%d moves tokenized, %d lines left as text\n", tokenizedLines, textLines)
+}
@@ -226,37 +226,46 @@ constexpr size_t StringBufferLength = StringLength256;	// Length of the string b
 #if SAM4E || SAM4S || SAME70 || ESP_NETWORKING
 // Increased GCODE_LENGTH on the SAM4 because M587 and M589 commands on the Duet WiFi can get very long and GCode meta commands can get even longer
 constexpr size_t GCODE_LENGTH = 201;					// maximum number of non-comment characters in a line of GCode including the null terminator
-constexpr size_t SHORT_GCODE_LENGTH = 61;				// maximum length of a GCode that we can queue to synchronise it to a move
+constexpr size_t SHORT_GCODE_LENGTH = 61;				// maximum length of a short GCode that we construct internally, e.g. from a menu item
 #else
 constexpr size_t GCODE_LENGTH = 101;					// maximum number of non-comment characters in a line of GCode including the null terminator
-constexpr size_t SHORT_GCODE_LENGTH = 61;				// maximum length of a GCode that we can queue to synchronise it to a move
+constexpr size_t SHORT_GCODE_LENGTH = 61;				// maximum length of a short GCode that we construct internally, e.g. from a menu item
 #endif
 
 // Output buffer length and number of buffers
 // When using RTOS, it is best if it is possible to fit an HTTP response header in a single buffer. Our headers are currently about 230 bytes long.
 // A note on reserved buffers: the worst case is when a GCode with a long response is processed. After string the response, there must be enough buffer space
 // for the HTTP responder to return a status response. Otherwise DWC never gets to know that it needs to make a rr_reply call and the system deadlocks.
+// Large output buffers are used in preference to normal ones when a response outgrows its first buffer, so that long responses need fewer buffers in the chain.
 #if SAME70
 constexpr size_t OUTPUT_BUFFER_SIZE = 256;				// How many bytes does each OutputBuffer hold?
-constexpr size_t OUTPUT_BUFFER_COUNT = 40;				// How many OutputBuffer instances do we have?
+constexpr size_t OUTPUT_BUFFER_COUNT = 32;				// How many OutputBuffer instances do we have?
+constexpr size_t LARGE_OUTPUT_BUFFER_SIZE = 1024;		// How many bytes does each large OutputBuffer hold?
+constexpr size_t LARGE_OUTPUT_BUFFER_COUNT = 2;			// How many large OutputBuffer instances do we have?
 constexpr size_t RESERVED_OUTPUT_BUFFERS = 4;			// Number of reserved output buffers after long responses, enough to hold a status response
 #elif SAM4E || SAM4S
 constexpr size_t OUTPUT_BUFFER_SIZE = 256;				// How many bytes does each OutputBuffer hold?
-constexpr size_t OUTPUT_BUFFER_COUNT = 24;				// How many OutputBuffer instances do we have?
+constexpr size_t OUTPUT_BUFFER_COUNT = 20;				// How many OutputBuffer instances do we have?
+constexpr size_t LARGE_OUTPUT_BUFFER_SIZE = 1024;		// How many bytes does each large OutputBuffer hold?
+constexpr size_t LARGE_OUTPUT_BUFFER_COUNT = 1;			// How many large OutputBuffer instances do we have?
 constexpr size_t RESERVED_OUTPUT_BUFFERS = 4;			// Number of reserved output buffers after long responses, enough to hold a status response
 #elif SAM3XA
 constexpr size_t OUTPUT_BUFFER_SIZE = 256;				// How many bytes does each OutputBuffer hold?
 constexpr size_t OUTPUT_BUFFER_COUNT = 16;				// How many OutputBuffer instances do we have?
+constexpr size_t LARGE_OUTPUT_BUFFER_SIZE = 1024;		// How many bytes does each large OutputBuffer hold?
+constexpr size_t LARGE_OUTPUT_BUFFER_COUNT = 0;			// How many large OutputBuffer instances do we have?
 constexpr size_t RESERVED_OUTPUT_BUFFERS = 2;			// Number of reserved output buffers after long responses
 #elif __LPC17xx__
 constexpr uint16_t OUTPUT_BUFFER_SIZE = 256;            // How many bytes does each OutputBuffer hold?
 constexpr size_t OUTPUT_BUFFER_COUNT = 16;              // How many OutputBuffer instances do we have?
+constexpr size_t LARGE_OUTPUT_BUFFER_SIZE = 1024;       // How many bytes does each large OutputBuffer hold?
+constexpr size_t LARGE_OUTPUT_BUFFER_COUNT = 0;         // How many large OutputBuffer instances do we have? We can't spare the RAM for them.
 constexpr size_t RESERVED_OUTPUT_BUFFERS = 2;           // Number of reserved output buffers after long responses. Must be enough for an HTTP header
 #else
 # error
 #endif
 
-constexpr size_t maxQueuedCodes = 16;					// How many codes can be queued?
+constexpr size_t CodeQueueArenaSize = 1280;			// How many bytes of storage we have for codes queued to synchronise them to moves
 
 // These two definitions are only used if TRACK_OBJECT_NAMES is defined, however that definition isn't available in this file
 #if SAME70
@@ -277,6 +286,9 @@ constexpr float MaxArcDeviation = 0.02;					// maximum deviation from ideal arc
 constexpr float MinArcSegmentLength = 0.1;				// G2 and G3 arc movement commands get split into segments at least this long
 constexpr float MaxArcSegmentLength = 2.0;				// G2 and G3 arc movement commands get split into segments at most this long
 constexpr float MinArcSegmentsPerSec = 50;
+constexpr unsigned int ArcCorrectionSegments = 25;		// how often we recalculate the arc position exactly instead of rotating it by the segment angle
+constexpr size_t MaxMergedMovePoints = 8;				// the maximum number of G1 moves after the first that we merge into a single move
+constexpr float MaxMergeExtrusionRateError = 0.02;		// G1 moves are only merged if their extrusion per mm differs by less than this proportion
 
 constexpr uint32_t DefaultIdleTimeout = 30000;			// Milliseconds
 constexpr float DefaultIdleCurrentFactor = 0.3;			// Proportion of normal motor current that we use for idle hold
@@ -318,7 +330,20 @@ constexpr size_t MAX_FILES = 4;							// Must be large enough to handle the max
 constexpr size_t MAX_FILES = 10;						// Must be large enough to handle the max number of concurrent web requests + file being printed + macros being executed + log file
 #endif
 
+#if defined(__LPC17xx__)
+constexpr size_t MaxFileInfoIndexEntries = 128;			// Max number of G-code files whose information we keep in the file info index
+#else
+constexpr size_t MaxFileInfoIndexEntries = 256;			// Max number of G-code files whose information we keep in the file info index
+#endif
+
+#if defined(__LPC17xx__)
+constexpr size_t ObjectModelPathCacheSize = 4;			// Number of object model paths in expressions whose table lookups we remember
+#else
+constexpr size_t ObjectModelPathCacheSize = 16;			// Number of object model paths in expressions whose table lookups we remember
+#endif
+
 constexpr size_t FILE_BUFFER_SIZE = 128;
+constexpr size_t FileClusterMapSize = 16;				// Number of words in the cluster map of each open file, enough for fast seeking in a read-only file with up to 7 fragments
 
 // Webserver stuff
 #define DEFAULT_PASSWORD		"reprap"				// Default machine password
@@ -339,6 +364,7 @@ constexpr size_t FILE_BUFFER_SIZE = 128;
 #define FILAMENTS_DIRECTORY "0:/filaments/"			// Directory for filament configurations
 #define FIRMWARE_DIRECTORY "0:/sys/"				// Directory for firmware and IAP files
 #define MENU_DIR "0:/menu/"							// Directory for menu files
+#define FILE_INFO_INDEX_FILE DEFAULT_SYS_DIR "fileinfo.idx"	// Index of the information parsed from G-code files
 
 // MaxExpectedWebDirFilenameLength is the maximum length of a filename that we can accept in a HTTP request without rejecting it out of hand
 // and perhaps warning the user of a possible virus attack.
@@ -29,7 +29,10 @@ void BinaryParser::Init() noexcept
 
 void BinaryParser::Put(const char *data, size_t len) noexcept
 {
-	memcpy(gb.buffer, data, len);
+	if (data != gb.buffer)								// tokenized moves are built in place
+	{
+		memcpy(gb.buffer, data, len);
+	}
 	bufferLength = len;
 	gb.bufferState = GCodeBufferState::ready;
 	gb.machineState->g53Active = (header->flags & CodeFlags::EnforceAbsolutePosition) != 0;
@@ -18,6 +18,27 @@
 NamedEnum(NamedConstant, unsigned int, _false, iterations, line, _null, pi, _result, _true);
 NamedEnum(Function, unsigned int, abs, acos, asin, atan, atan2, cos, degrees, floor, isnan, max, min, mod, radians, sin, sqrt, tan);
 
+// Table lookups for recently-used object model paths. Expressions are only evaluated by the main task, so we don't need a lock.
+static ObjectModelPathCacheEntry pathCache[ObjectModelPathCacheSize];
+
+// Return the path cache entry to use when looking up this object model path
+static ObjectModelPathCacheEntry *GetPathCacheEntry(const char *path) noexcept
+{
+	uint32_t hash = 2166136261u;											// FNV-1a hash of the path
+	while (*path != 0)
+	{
+		hash = (hash ^ (uint8_t)*path++) * 16777619u;
+	}
+
+	ObjectModelPathCacheEntry * const entry = &pathCache[hash % ObjectModelPathCacheSize];
+	if (entry->pathHash != hash)
+	{
+		entry->pathHash = hash;
+		entry->numSteps = 0;
+	}
+	return entry;
+}
+
 ExpressionParser::ExpressionParser(const GCodeBuffer& p_gb, const char *text, const char *textLimit, int p_column) noexcept
 	: currentp(text), startp(text), endp(textLimit), gb(p_gb), column(p_column), stringBuffer(stringBufferStorage, ARRAY_SIZE(stringBufferStorage))
 {
@@ -930,7 +951,12 @@ ExpressionValue ExpressionParser::ParseIdentifierExpression(bool evaluate, bool
 	}
 
 	// If we are not evaluating then the object expression doesn't have to exist, so don't retrieve it because that might throw an error
-	return (evaluate) ? reprap.GetObjectValue(context, nullptr, id.c_str()) : ExpressionValue(nullptr);
+	if (!evaluate)
+	{
+		return ExpressionValue(nullptr);
+	}
+	context.SetPathCacheEntry(GetPathCacheEntry(id.c_str()));
+	return reprap.GetObjectValue(context, nullptr, id.c_str());
 }
 
 // Parse a quoted string, given that the current character is double-quote
@@ -21,9 +21,16 @@
 
 #if HAS_LINUX_INTERFACE
 
-# define PARSER_OPERATION(_x)	((isBinaryBuffer) ? (binaryParser._x) : (stringParser._x))
-# define NOT_BINARY_AND(_x)		((!isBinaryBuffer) && (_x))
-# define IF_NOT_BINARY(_x)		{ if (!isBinaryBuffer) { _x; } }
+// Tokenized moves from print files are executed by the binary parser, but replies to them are not binary
+# if SUPPORT_TOKENIZED_GCODE
+#  define USING_BINARY_PARSER	(isBinaryBuffer || isTokenizedCode)
+# else
+#  define USING_BINARY_PARSER	(isBinaryBuffer)
+# endif
+
+# define PARSER_OPERATION(_x)	((USING_BINARY_PARSER) ? (binaryParser._x) : (stringParser._x))
+# define NOT_BINARY_AND(_x)		((!USING_BINARY_PARSER) && (_x))
+# define IF_NOT_BINARY(_x)		{ if (!USING_BINARY_PARSER) { _x; } }
 
 #else
 
@@ -94,6 +101,9 @@ GCodeBuffer::GCodeBuffer(GCodeChannel::RawType channel, GCodeInput *normalIn, Fi
 	  machineState(new GCodeMachineState()),
 #if HAS_LINUX_INTERFACE
 	  isBinaryBuffer(false),
+#if SUPPORT_TOKENIZED_GCODE
+	  isTokenizedCode(false),
+#endif
 #endif
 	  timerRunning(false), motionCommanded(false)
 {
@@ -119,6 +129,9 @@ void GCodeBuffer::Init() noexcept
 #if HAS_LINUX_INTERFACE
 	sendToSbc = false;
 	binaryParser.Init();
+#endif
+#if SUPPORT_TOKENIZED_GCODE
+	isTokenizedCode = false;
 #endif
 	stringParser.Init();
 	timerRunning = false;
@@ -203,10 +216,26 @@ bool GCodeBuffer::Put(char c) noexcept
 {
 #if HAS_LINUX_INTERFACE
 	isBinaryBuffer = false;
+#endif
+#if SUPPORT_TOKENIZED_GCODE
+	isTokenizedCode = false;
 #endif
 	return stringParser.Put(c);
 }
 
+// Add a block of characters from a file. Return true if a command is complete, in which case 'bytesUsed' is the number of characters consumed up to the end of it.
+// If false is returned then all the characters were consumed.
+bool GCodeBuffer::PutBlock(const char *data, size_t len, size_t& bytesUsed) noexcept
+{
+#if HAS_LINUX_INTERFACE
+	isBinaryBuffer = false;
+#endif
+#if SUPPORT_TOKENIZED_GCODE
+	isTokenizedCode = false;
+#endif
+	return stringParser.PutBlock(data, len, bytesUsed);
+}
+
 // Decode the command in the buffer when it is complete
 void GCodeBuffer::DecodeCommand() noexcept
 {
@@ -225,6 +254,9 @@ bool GCodeBuffer::CheckMetaCommand(const StringRef& reply)
 void GCodeBuffer::PutAndDecode(const char *str, size_t len, bool isBinary) noexcept
 {
 	isBinaryBuffer = isBinary;
+#if SUPPORT_TOKENIZED_GCODE
+	isTokenizedCode = false;
+#endif
 	if (isBinary)
 	{
 		binaryParser.Put(str, len);
@@ -249,10 +281,48 @@ void GCodeBuffer::PutAndDecode(const char *str) noexcept
 {
 #if HAS_LINUX_INTERFACE
 	isBinaryBuffer = false;
+#endif
+#if SUPPORT_TOKENIZED_GCODE
+	isTokenizedCode = false;
 #endif
 	stringParser.PutAndDecode(str);
 }
 
+#if SUPPORT_TOKENIZED_GCODE
+
+// Add a G0/G1/G2/G3 command read from a tokenized file. We store it in the format that the binary parser uses, so that it can be executed without parsing any text.
+void GCodeBuffer::PutTokenizedMove(unsigned int code, uint32_t letters, const float *values, FilePosition filePos) noexcept
+{
+	CodeHeader * const header = reinterpret_cast<CodeHeader*>(buffer);
+	header->channel = codeChannel.ToBaseType();
+	header->flags = (CodeFlags)(CodeFlags::HasMajorCommandNumber | CodeFlags::HasFilePosition);
+	header->numParameters = 0;
+	header->letter = 'G';
+	header->majorCode = code;
+	header->minorCode = 0;
+	header->filePosition = filePos;
+	header->lineNumber = machineState->lineNumber + 1;
+
+	CodeParameter *param = reinterpret_cast<CodeParameter*>(buffer + sizeof(CodeHeader));
+	for (char letter = 'A'; letters != 0; ++letter, letters >>= 1)
+	{
+		if (letters & 1u)
+		{
+			param->letter = letter;
+			param->type = DataType::Float;
+			param->padding = 0;
+			param->floatValue = *values++;
+			++param;
+			++header->numParameters;
+		}
+	}
+
+	isTokenizedCode = true;
+	binaryParser.Put(buffer, reinterpret_cast<const char*>(param) - buffer);
+}
+
+#endif
+
 void GCodeBuffer::StartNewFile() noexcept
 {
 	machineState->lineNumber = 0;						// reset line numbering when M32 is run
@@ -614,6 +684,9 @@ void GCodeBuffer::SetFinished(bool f) noexcept
 		sendToSbc = false;
 #endif
 		PARSER_OPERATION(SetFinished());
+#if SUPPORT_TOKENIZED_GCODE
+		isTokenizedCode = false;
+#endif
 	}
 	else
 	{
@@ -50,12 +50,16 @@ public:
 	void Diagnostics(MessageType mtype) noexcept;								// Write some debug info
 
 	bool Put(char c) noexcept __attribute__((hot));								// Add a character to the end
+	bool PutBlock(const char *data, size_t len, size_t& bytesUsed) noexcept __attribute__((hot));	// Add a block of characters, stopping when a command is complete
 #if HAS_LINUX_INTERFACE
 	void PutAndDecode(const char *data, size_t len, bool isBinary = false) noexcept;	// Add an entire G-Code, overwriting any existing content
 #else
 	void PutAndDecode(const char *data, size_t len) noexcept;					// Add an entire G-Code, overwriting any existing content
 #endif
 	void PutAndDecode(const char *str) noexcept;								// Add a null-terminated string, overwriting any existing content
+#if SUPPORT_TOKENIZED_GCODE
+	void PutTokenizedMove(unsigned int code, uint32_t letters, const float *values, FilePosition filePos) noexcept;	// Add a move read from a tokenized file
+#endif
 	void StartNewFile() noexcept;												// Called when we start a new file
 	bool FileEnded() noexcept;													// Called when we reach the end of the file we are reading from
 	void DecodeCommand() noexcept;												// Decode the command in the buffer when it is complete
@@ -231,6 +235,9 @@ private:
 
 #if HAS_LINUX_INTERFACE
 	bool isBinaryBuffer;
+#endif
+#if SUPPORT_TOKENIZED_GCODE
+	bool isTokenizedCode;								// true if the binary parser is executing a move that was read from a tokenized file
 #endif
 	bool timerRunning;									// True if we are waiting
 	bool motionCommanded;								// true if this GCode stream has commanded motion since it last waited for motion to stop
@@ -25,6 +25,10 @@
 static constexpr char eofString[] = EOF_STRING;		// What's at the end of an HTML file?
 #endif
 
+// Powers of 10 that are exactly representable as floats, used by the fast path in ReadFloatValue
+static constexpr float ExactPowersOfTen[] = { 1.0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9, 1.0e10 };
+constexpr uint32_t MaxExactFloatInteger = (1u << 24) - 1;	// integers up to this value are exactly representable as floats
+
 StringParser::StringParser(GCodeBuffer& gcodeBuffer) noexcept
 	: gb(gcodeBuffer), fileBeingWritten(nullptr), writingFileSize(0), eofStringCounter(0), indentToSkipTo(NoIndentSkip),
 	  hasCommandNumber(false), commandLetter('Q'), checksumRequired(false), binaryWriting(false)
@@ -40,6 +44,7 @@ void StringParser::Init() noexcept
 	gcodeLineEnd = 0;
 	commandLength = 0;
 	readPointer = -1;
+	parametersIndexed = false;
 	hadLineNumber = hadChecksum = overflowed = false;
 	computedChecksum = 0;
 	gb.bufferState = GCodeBufferState::parseNotStarted;
@@ -266,6 +271,100 @@ bool StringParser::Put(char c) noexcept
 	return false;
 }
 
+// Return true if the 32-bit word contains a zero byte
+static inline bool HasZeroByte(uint32_t w) noexcept
+{
+	return ((w - 0x01010101u) & ~w & 0x80808080u) != 0;
+}
+
+// Return a pointer to the first null, CR or LF character in the range [p, end), or 'end' if there is none.
+// Once the pointer is word-aligned we test 4 characters at a time, which is much faster than feeding them one by one through the state machine.
+static const char *FindLineEnd(const char *p, const char *end) noexcept
+{
+	while (p < end && ((uintptr_t)p & 3u) != 0)
+	{
+		if (*p == 0 || *p == '\n' || *p == '\r')
+		{
+			return p;
+		}
+		++p;
+	}
+
+	while (end - p >= 4)
+	{
+		uint32_t w;
+		memcpy(&w, p, sizeof(w));											// the compiler turns this into a single aligned load
+		if (HasZeroByte(w) || HasZeroByte(w ^ 0x0A0A0A0Au) || HasZeroByte(w ^ 0x0D0D0D0Du))
+		{
+			break;
+		}
+		p += 4;
+	}
+
+	while (p < end && *p != 0 && *p != '\n' && *p != '\r')
+	{
+		++p;
+	}
+	return p;
+}
+
+// Add a block of characters to the code being assembled. This is used for files, where most of the bytes are often comments (e.g. slicer settings and thumbnails).
+// The remainder of a line after an end-of-line comment or checksum and the text of whole-line comments are handled a word at a time instead of being fed through Put,
+// and whole-line comments that GCodes would ignore are dropped instead of being returned as commands.
+// Return true if a command is complete, in which case 'bytesUsed' is the number of characters consumed up to and including the end of that line; else all the characters were consumed.
+bool StringParser::PutBlock(const char *data, size_t len, size_t& bytesUsed) noexcept
+{
+	const char * const end = data + len;
+	const char *p = data;
+	while (p < end)
+	{
+		if (gb.bufferState == GCodeBufferState::discarding || gb.bufferState == GCodeBufferState::parsingComment)
+		{
+			const char * const lineEnd = FindLineEnd(p, end);
+			const size_t count = lineEnd - p;
+			if (gb.bufferState == GCodeBufferState::parsingComment)
+			{
+				// Store as much of the comment as will fit. We don't care if comment lines overflow and we don't checksum them.
+				const size_t countToStore = min<size_t>(count, ARRAY_SIZE(gb.buffer) - 1 - gcodeLineEnd);
+				memcpy(gb.buffer + gcodeLineEnd, p, countToStore);
+				gcodeLineEnd += countToStore;
+			}
+			commandLength += count;
+			p = lineEnd;
+			if (p == end)
+			{
+				break;
+			}
+		}
+
+		if (Put(*p++))
+		{
+			if (gb.bufferState == GCodeBufferState::parsingComment && CanDiscardWholeLineComment())
+			{
+				Init();
+				seenLeadingSpace = seenLeadingTab = false;						// as CheckMetaCommand would have done for this unindented line
+			}
+			else
+			{
+				bytesUsed = p - data;
+				return true;
+			}
+		}
+	}
+
+	bytesUsed = len;
+	return false;
+}
+
+// Return true if the whole-line comment that we have just finished reading can be dropped instead of being executed as a Q0 command.
+// A comment at the outer indentation level ends any blocks that we are in, so we only drop it if we are not in a block.
+bool StringParser::CanDiscardWholeLineComment() const noexcept
+{
+	return indentToSkipTo == NoIndentSkip
+		&& gb.machineState->CurrentBlockIndent() == 0
+		&& !GCodes::IsWholeLineCommentOfInterest(gb.buffer + 1);				// skip the leading ';'
+}
+
 // This is called when we are fed a null, CR or LF character.
 // Return true if there is a completed command ready to be executed.
 bool StringParser::LineFinished()
@@ -816,6 +915,7 @@ void StringParser::DecodeCommand() noexcept
 		commandEnd = gcodeLineEnd;
 	}
 
+	parametersIndexed = false;						// we build the parameter index when Seen is first called
 	gb.bufferState = GCodeBufferState::ready;
 }
 
@@ -877,7 +977,7 @@ FilePosition StringParser::GetFilePosition() const noexcept
 # endif
 	   )
 	{
-		return gb.machineState->fileState.GetPosition() - gb.fileInput->BytesCached() - commandLength + commandStart;
+		return gb.machineState->fileState.GetPosition() - gb.fileInput->FileBytesCached() - commandLength + commandStart;
 	}
 #endif
 	return noFilePosition;
@@ -893,10 +993,65 @@ size_t StringParser::DataLength() const noexcept
 	return commandEnd - commandStart;
 }
 
+// Record where each parameter letter first occurs in the current command, so that Seen doesn't need to scan the command each time it is called.
+// A G1 command is typically tested for every axis letter and several other letters, most of which are not present.
+void StringParser::IndexParameters() noexcept
+{
+	memset(parameterOffsets, 0, sizeof(parameterOffsets));
+	bool inQuotes = false;
+	unsigned int inBrackets = 0;
+	for (unsigned int i = parameterStart; i < commandEnd; ++i)
+	{
+		const char b = gb.buffer[i];
+		if (b == '"')
+		{
+			inQuotes = !inQuotes;
+		}
+		else if (!inQuotes)
+		{
+			if (inBrackets == 0)
+			{
+				const char c = toupper(b);
+				if (   c >= 'A' && c <= 'Z' && parameterOffsets[c - 'A'] == 0
+					&& (c != 'E' || i == parameterStart || !isdigit(gb.buffer[i - 1]))		// an E following a digit is an exponent
+				   )
+				{
+					parameterOffsets[c - 'A'] = (uint8_t)(i - parameterStart + 1);
+				}
+			}
+			if (b == '{')
+			{
+				++inBrackets;
+			}
+			else if (b == '}' && inBrackets != 0)
+			{
+				--inBrackets;
+			}
+		}
+	}
+	parametersIndexed = true;
+}
+
 // Is 'c' in the G Code string? 'c' must be uppercase.
 // Leave the pointer one after it for a subsequent read.
 bool StringParser::Seen(char c) noexcept
 {
+	if (c >= 'A' && c <= 'Z')
+	{
+		if (!parametersIndexed)
+		{
+			IndexParameters();
+		}
+		const unsigned int offset = parameterOffsets[c - 'A'];
+		if (offset == 0)
+		{
+			readPointer = -1;
+			return false;
+		}
+		readPointer = parameterStart + offset;
+		return true;
+	}
+
 	bool inQuotes = false;
 	unsigned int inBrackets = 0;
 	for (readPointer = parameterStart; (unsigned int)readPointer < commandEnd; ++readPointer)
@@ -1190,6 +1345,7 @@ void StringParser::InternalGetPossiblyQuotedString(const StringRef& str) THROWS(
 	else
 	{
 		commandEnd = gcodeLineEnd;				// the string is the remainder of the line of gcode
+		parametersIndexed = false;
 		for (;;)
 		{
 			const char c = gb.buffer[readPointer++];
@@ -1586,6 +1742,43 @@ float StringParser::ReadFloatValue() THROWS(GCodeException)
 		return val;
 	}
 
+	// Fast path for plain decimal numbers such as the coordinates in G1 commands.
+	// If the digits form an integer that is exactly representable as a float and there are no more than 10 decimal places, then a single float division
+	// of two exact values gives the correctly-rounded result, which is the same as the one from SafeStrtof. Anything else goes to SafeStrtof.
+	{
+		const char *p = gb.buffer + readPointer;
+		const bool negative = (*p == '-');
+		if (negative)
+		{
+			++p;
+		}
+		uint32_t mantissa = 0;
+		unsigned int numDigits = 0, numFractionDigits = 0;
+		while (isdigit(*p) && mantissa <= MaxExactFloatInteger)
+		{
+			mantissa = (10 * mantissa) + (*p++ - '0');
+			++numDigits;
+		}
+		if (*p == '.')
+		{
+			++p;
+			while (isdigit(*p) && mantissa <= MaxExactFloatInteger)
+			{
+				mantissa = (10 * mantissa) + (*p++ - '0');
+				++numDigits;
+				++numFractionDigits;
+			}
+		}
+		if (   numDigits != 0 && mantissa <= MaxExactFloatInteger && numFractionDigits < ARRAY_SIZE(ExactPowersOfTen)
+			&& !isdigit(*p) && toupper(*p) != 'E' && toupper(*p) != 'X'				// an exponent or a hex number needs the full conversion
+		   )
+		{
+			const float rslt = (float)mantissa/ExactPowersOfTen[numFractionDigits];
+			readPointer = p - gb.buffer;
+			return (negative) ? -rslt : rslt;
+		}
+	}
+
 	const char *endptr;
 	const float rslt = SafeStrtof(gb.buffer + readPointer, &endptr);
 	readPointer = endptr - gb.buffer;
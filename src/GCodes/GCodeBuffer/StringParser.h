@@ -28,6 +28,7 @@ public:
 	void Init() noexcept; 													// Set it up to parse another G-code
 	void Diagnostics(MessageType mtype) noexcept;							// Write some debug info
 	bool Put(char c) noexcept __attribute__((hot));							// Add a character to the end
+	bool PutBlock(const char *data, size_t len, size_t& bytesUsed) noexcept __attribute__((hot));	// Add a block of characters, stopping when a command is complete
 	void PutCommand(const char *str) noexcept;								// Put a complete command but don't decode it
 	void DecodeCommand() noexcept;											// Decode the next command in the line
 	void PutAndDecode(const char *str, size_t len) noexcept;				// Add an entire string, overwriting any existing content
@@ -92,10 +93,12 @@ private:
 	void AddToChecksum(char c) noexcept;
 	void StoreAndAddToChecksum(char c) noexcept;
 	bool LineFinished() THROWS(GCodeException);									// Deal with receiving end-of-line and return true if we have a command
+	bool CanDiscardWholeLineComment() const noexcept;							// Return true if the whole-line comment we just read need not be executed
 	void InternalGetQuotedString(const StringRef& str) THROWS(GCodeException)
 		pre (readPointer >= 0; gb.buffer[readPointer] == '"'; str.IsEmpty());
 	void InternalGetPossiblyQuotedString(const StringRef& str) THROWS(GCodeException)
 		pre (readPointer >= 0);
+	void IndexParameters() noexcept;											// Record where each parameter letter first occurs in the current command
 	float ReadFloatValue() THROWS(GCodeException);
 	uint32_t ReadUIValue() THROWS(GCodeException);
 	int32_t ReadIValue() THROWS(GCodeException);
@@ -127,6 +130,8 @@ private:
 	unsigned int braceCount;							// how many nested { } we are inside
 	unsigned int gcodeLineEnd;							// Number of characters in the entire line of gcode
 	int readPointer;									// Where in the buffer to read next, or -1
+	uint8_t parameterOffsets[26];						// For each letter A-Z, 1 + the offset from parameterStart where it first occurs as a parameter, or 0 if it doesn't
+	bool parametersIndexed;								// True if parameterOffsets is valid for the current command
 
 	FileStore *fileBeingWritten;						// If we are copying GCodes to a file, which file it is
 	FilePosition writingFileSize;						// Size of the file being written, or zero if not known
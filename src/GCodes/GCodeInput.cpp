@@ -10,6 +10,7 @@
 #include "RepRap.h"
 #include "GCodes.h"
 #include "GCodeBuffer/GCodeBuffer.h"
+#include "Movement/StepTimer.h"
 
 // Read some input bytes into the GCode buffer. Return true if there is a line of GCode waiting to be processed.
 bool StandardGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept
@@ -227,6 +228,11 @@ bool NetworkGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept /*override*/
 void FileGCodeInput::Reset() noexcept
 {
 	lastFile = nullptr;
+	ClearReadAhead();
+#if SUPPORT_TOKENIZED_GCODE
+	tokenized = fileEnded = false;
+	atLineStart = true;
+#endif
 	RegularGCodeInput::Reset();
 }
 
@@ -242,49 +248,290 @@ void FileGCodeInput::Reset(const FileData &file) noexcept
 // Read another chunk of G-codes from the file and return true if more data is available
 GCodeInputReadResult FileGCodeInput::ReadFromFile(FileData &file) noexcept
 {
-	const size_t bytesCached = BytesCached();
-
 	// Keep track of the last file we read from
-	if (lastFile != nullptr && lastFile != file.f)
+	if (lastFile != file.f)
 	{
-		if (bytesCached > 0)
+		if (lastFile != nullptr)
+		{
+			const size_t bytesCached = FileBytesCached();
+			if (bytesCached > 0)
+			{
+				// Rewind back to the right position so we can resume at the right position later.
+				// This may be necessary when nested macros are executed.
+				lastFile->Seek(lastFile->Position() - bytesCached);
+			}
+
+			RegularGCodeInput::Reset();
+			ClearReadAhead();
+		}
+		lastFile = file.f;
+		if (!CheckFileFormat(file))
 		{
-			// Rewind back to the right position so we can resume at the right position later.
-			// This may be necessary when nested macros are executed.
-			lastFile->Seek(lastFile->Position() - bytesCached);
+			lastFile = nullptr;				// so that we check again if we are asked to read it again
+			return GCodeInputReadResult::error;
 		}
+	}
 
-		RegularGCodeInput::Reset();
+	// Keep the read-ahead buffers topped up. We read at most one buffer per call, so most reads are done while the parser still has data to work on
+	// rather than at the moment it runs out, and no single call blocks for longer than one read.
+	const size_t bytesCached = BytesCached();
+	if (numFullBuffers < NumFileReadAheadBuffers && !ReadAhead(bytesCached == 0 && numFullBuffers == 0))
+	{
+		return GCodeInputReadResult::error;
 	}
-	lastFile = file.f;
 
-	// Read more from the file
-	if (bytesCached < GCodeInputFileReadThreshold)
+	// Pass more data to the ring buffer
+	if (bytesCached < GCodeInputFileReadThreshold && numFullBuffers != 0)
 	{
 		// Reset the read+write pointers for better performance if possible
 		if (readingPointer == writingPointer)
 		{
 			readingPointer = writingPointer = 0;
 		}
+		TransferReadAheadData();
+	}
+
+	return (BytesCached() > 0) ? GCodeInputReadResult::haveData : GCodeInputReadResult::noData;
+}
+
+// Return the number of bytes we have read from the file that the GCodeBuffer has not had yet
+size_t FileGCodeInput::FileBytesCached() const noexcept
+{
+	size_t bytesCached = BytesCached();
+	for (size_t i = 0; i < numFullBuffers; ++i)
+	{
+		const ReadAheadBuffer& rab = readAheadBuffers[(firstFullBuffer + i) % NumFileReadAheadBuffers];
+		bytesCached += rab.length - rab.readPointer;
+	}
+	return bytesCached;
+}
+
+void FileGCodeInput::Diagnostics(MessageType mtype) noexcept
+{
+	reprap.GetPlatform().MessageF(mtype, "File reads %" PRIu32 ", %.1fus avg, %" PRIu32 "us max, stalled %" PRIu32 ", %.1fus avg\n",
+									readTiming.GetNumSamples(), (double)readTiming.GetMicrosecondsPerSample(),
+									(uint32_t)(((uint64_t)readTiming.GetMaxClocks() * 1000000u)/StepTimer::StepClockRate),
+									stallTiming.GetNumSamples(), (double)stallTiming.GetMicrosecondsPerSample());
+	readTiming.Clear();
+	stallTiming.Clear();
+}
+
+void FileGCodeInput::ClearReadAhead() noexcept
+{
+	firstFullBuffer = numFullBuffers = 0;
+}
+
+// Read the file into the next free read-ahead buffer, returning false if there was a file error.
+// If 'stalled' is true then the parser has no data left, so it has to wait for this read.
+bool FileGCodeInput::ReadAhead(bool stalled) noexcept
+{
+	ReadAheadBuffer& rab = readAheadBuffers[(firstFullBuffer + numFullBuffers) % NumFileReadAheadBuffers];
+
+	// Read up to the next multiple of the buffer size, so that after the first read FatFS transfers whole sectors directly into our buffer
+	// instead of copying them through its own sector buffer
+	const size_t bytesToRead = FileReadAheadBufferSize - (size_t)(lastFile->Position() % FileReadAheadBufferSize);
+	const uint32_t startTime = StepTimer::GetTimerTicks();
+	const int bytesRead = lastFile->Read(rab.data, bytesToRead);
+	const uint32_t readClocks = StepTimer::GetTimerTicks() - startTime;
+	if (bytesRead < 0)
+	{
+		return false;
+	}
 
-		// The code here used to read into a local buffer in blocks that are multiples of 4 bytes.
-		// However, unless we can use a buffer of at least 512 bytes then that is redundant,
-		// because the data will be copied via the sector buffer in FatFS anyway. So we don't do that any more.
-		const int bytesRead = file.Read(buffer + writingPointer, min<size_t>(BufferSpaceLeft(), GCodeInputBufferSize - writingPointer));
-		if (bytesRead < 0)
+#if SUPPORT_TOKENIZED_GCODE
+	fileEnded = (bytesRead == 0);
+#endif
+	if (bytesRead > 0)
+	{
+		readTiming.Add(readClocks, (uint32_t)bytesRead);
+		if (stalled)
 		{
-			return GCodeInputReadResult::error;
+			stallTiming.Add(readClocks, (uint32_t)bytesRead);
+		}
+		rab.length = (size_t)bytesRead;
+		rab.readPointer = 0;
+		++numFullBuffers;
+	}
+	return true;
+}
+
+// Copy as much data as will fit from the read-ahead buffers to the ring buffer
+void FileGCodeInput::TransferReadAheadData() noexcept
+{
+	while (numFullBuffers != 0)
+	{
+		const size_t spaceLeft = min<size_t>(BufferSpaceLeft(), GCodeInputBufferSize - writingPointer);
+		if (spaceLeft == 0)
+		{
+			break;
 		}
-		if (bytesRead > 0)
+
+		ReadAheadBuffer& rab = readAheadBuffers[firstFullBuffer];
+		const size_t bytesToCopy = min<size_t>(spaceLeft, rab.length - rab.readPointer);
+		memcpy(buffer + writingPointer, rab.data + rab.readPointer, bytesToCopy);
+		writingPointer = (writingPointer + bytesToCopy) % GCodeInputBufferSize;
+		rab.readPointer += bytesToCopy;
+		if (rab.readPointer == rab.length)
 		{
-			writingPointer = (writingPointer + (size_t)bytesRead) % GCodeInputBufferSize;
-			return GCodeInputReadResult::haveData;
+			firstFullBuffer = (firstFullBuffer + 1) % NumFileReadAheadBuffers;
+			--numFullBuffers;
 		}
 	}
+}
+
+// Read some input bytes into the GCode buffer. Return true if there is a G-code waiting to be processed.
+// Unless we are writing a file or uploading binary data, we pass the contents of the ring buffer to the GCode buffer in contiguous blocks so that comments can be skipped in bulk.
+bool FileGCodeInput::FillBuffer(GCodeBuffer *gb) noexcept
+{
+#if SUPPORT_TOKENIZED_GCODE
+	if (tokenized)
+	{
+		return FillBufferTokenized(gb);
+	}
+#endif
 
-	return (bytesCached > 0) ? GCodeInputReadResult::haveData : GCodeInputReadResult::noData;
+	if (gb->IsWritingFile() || gb->IsWritingBinary())
+	{
+		return RegularGCodeInput::FillBuffer(gb);
+	}
+
+	while (readingPointer != writingPointer)
+	{
+		const size_t blockLength = ((writingPointer > readingPointer) ? writingPointer : GCodeInputBufferSize) - readingPointer;
+		size_t bytesUsed;
+		const bool complete = gb->PutBlock(buffer + readingPointer, blockLength, bytesUsed);
+		readingPointer = (readingPointer + bytesUsed) % GCodeInputBufferSize;
+		if (complete)
+		{
+			return true;
+		}
+	}
+
+	return false;
 }
 
+// Set up for the format of the file we have just switched to, returning false if we can't execute it.
+// We do this whenever we switch files rather than only when we start reading at the beginning, so that tokenized moves are still recognised
+// after a nested macro returns or when a print is resumed part way through. The format is kept in the FileData, so we only read the header once.
+bool FileGCodeInput::CheckFileFormat(FileData &file) noexcept
+{
+	if (file.format == FileData::Format::unknown)
+	{
+		const FilePosition pos = lastFile->Position();
+		char magic[sizeof(TokenizedFileMagic) - 1];
+		const bool isTokenized = lastFile->Seek(0)
+									&& lastFile->Read(magic, sizeof(magic)) == (int)sizeof(magic)
+									&& memcmp(magic, TokenizedFileMagic, sizeof(magic)) == 0;
+		lastFile->Seek(pos);
+		file.format = (isTokenized) ? FileData::Format::tokenized : FileData::Format::text;
+	}
+
+#if SUPPORT_TOKENIZED_GCODE
+	tokenized = (file.format == FileData::Format::tokenized);
+	atLineStart = true;
+	fileEnded = false;
+#else
+	if (file.format == FileData::Format::tokenized)
+	{
+		reprap.GetPlatform().Message(ErrorMessage, "this firmware build does not support tokenized G-code files\n");
+		return false;
+	}
+#endif
+	return true;
+}
+
+#if SUPPORT_TOKENIZED_GCODE
+
+// Read some input bytes from a tokenized file into the GCode buffer. Return true if there is a G-code waiting to be processed.
+// This is the same as StandardGCodeInput::FillBuffer except that we look for tokenized moves at the start of each line.
+bool FileGCodeInput::FillBufferTokenized(GCodeBuffer *gb) noexcept
+{
+	const size_t bytesToPass = min<size_t>(BytesCached(), GCODE_LENGTH);
+	for (size_t i = 0; i < bytesToPass; i++)
+	{
+		if (atLineStart && PeekByte(0) == TokenizedMoveTag)
+		{
+			return ReadTokenizedMove(gb);
+		}
+
+		const char c = ReadByte();
+		atLineStart = (c == '\n' || c == '\r');
+		if (gb->IsWritingBinary())
+		{
+			// HTML uploads are handled by the GCodes class
+			gb->WriteBinaryToFile(c);
+		}
+		else if (gb->Put(c))
+		{
+			if (gb->IsWritingFile())
+			{
+				gb->WriteToFile();
+			}
+			else
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// Pass a tokenized move to the GCode buffer. Return true if we did, false if we need to wait for more data from the file.
+bool FileGCodeInput::ReadTokenizedMove(GCodeBuffer *gb) noexcept
+{
+	const size_t bytesCached = BytesCached();
+	if (bytesCached >= TokenizedMoveHeaderSize)
+	{
+		const unsigned int code = (uint8_t)PeekByte(1);
+		uint32_t letters = 0;
+		for (size_t i = 0; i < sizeof(letters); ++i)
+		{
+			letters |= (uint32_t)(uint8_t)PeekByte(2 + i) << (8 * i);
+		}
+
+		if (code > 3 || letters >= (1u << 26))
+		{
+			// Not a valid tokenized move, so pass it to the string parser, which will report the error
+			atLineStart = false;
+			return false;
+		}
+
+		const size_t numParameters = __builtin_popcount(letters);
+		if (bytesCached >= TokenizedMoveHeaderSize + numParameters * sizeof(float))
+		{
+			const FilePosition recordStart = lastFile->Position() - FileBytesCached();
+			for (size_t i = 0; i < TokenizedMoveHeaderSize; ++i)
+			{
+				(void)ReadByte();
+			}
+
+			float values[26];
+			for (size_t i = 0; i < numParameters; ++i)
+			{
+				uint32_t bits = 0;
+				for (size_t j = 0; j < sizeof(bits); ++j)
+				{
+					bits |= (uint32_t)(uint8_t)ReadByte() << (8 * j);
+				}
+				memcpy(&values[i], &bits, sizeof(float));
+			}
+
+			gb->PutTokenizedMove(code, letters, values, recordStart);
+			return true;
+		}
+	}
+
+	if (fileEnded && numFullBuffers == 0)
+	{
+		// The file ends part way through a tokenized move, so discard it
+		readingPointer = writingPointer;
+	}
+	return false;
+}
+
+#endif
+
 #endif
 
 // End
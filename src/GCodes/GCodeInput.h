@@ -12,6 +12,7 @@
 #include "Storage/FileData.h"
 #include "MessageType.h"
 #include "RTOSIface/RTOSIface.h"
+#include "Movement/TimingHistogram.h"
 
 const size_t GCodeInputBufferSize = 256;						// How many bytes can we cache per input source?
 const size_t GCodeInputFileReadThreshold = 128;					// How many free bytes must be available before data is read from the SD card?
@@ -91,21 +92,84 @@ enum class GCodeInputReadResult : uint8_t { haveData, noData, error };
 
 #if HAS_MASS_STORAGE
 
+// Data is read from the file into these buffers ahead of when it is needed, so that we read whole sectors and can choose when to do it
+#if SAM4E || SAM4S || SAME70
+const size_t NumFileReadAheadBuffers = 2;
+const size_t FileReadAheadBufferSize = 2048;
+#elif defined(__LPC17xx__)
+const size_t NumFileReadAheadBuffers = 2;
+const size_t FileReadAheadBufferSize = 512;
+#else
+const size_t NumFileReadAheadBuffers = 2;
+const size_t FileReadAheadBufferSize = 1024;
+#endif
+
+// A tokenized print file starts with this line, so it is still valid G-code when it is read as text.
+// After that, a line that starts with TokenizedMoveTag is a G0/G1/G2/G3 command in binary form, which is not terminated by a newline:
+//   uint8_t tag, uint8_t command number, uint32_t letter bitmap (bit N set if letter 'A'+N is present), then a float for each letter present in alphabetical order.
+// All multi-byte values are little-endian and not aligned. Any other line is plain G-code. A tokenized move must not directly follow an indented line,
+// because the string parser needs to see a line at the outer indentation level to end a conditional block or loop.
+// Builds that don't support tokenized files still recognise the first line, so that they can refuse the file instead of executing the binary moves as text.
+constexpr char TokenizedFileMagic[] = ";RRF tokenized G-code v1\n";
+
+#if SUPPORT_TOKENIZED_GCODE
+
+constexpr char TokenizedMoveTag = '\x01';
+constexpr size_t TokenizedMoveHeaderSize = 6;
+
+#endif
+
 // This class is an expansion of the RegularGCodeInput class to buffer G-codes and to rewind file positions when
 // nested G-code files are started. However buffered codes are not explicitly checked for M112.
 class FileGCodeInput : public RegularGCodeInput
 {
 public:
 
-	FileGCodeInput() noexcept : RegularGCodeInput(), lastFile(nullptr) { }
+#if SUPPORT_TOKENIZED_GCODE
+	FileGCodeInput() noexcept : RegularGCodeInput(), lastFile(nullptr), firstFullBuffer(0), numFullBuffers(0), tokenized(false), atLineStart(true), fileEnded(false) { }
+#else
+	FileGCodeInput() noexcept : RegularGCodeInput(), lastFile(nullptr), firstFullBuffer(0), numFullBuffers(0) { }
+#endif
 
 	void Reset() noexcept override;								// Clears the buffer. Should be called when the associated file is being closed
 	void Reset(const FileData &file) noexcept;					// Clears the buffer of a specific file. Should be called when it is closed or re-opened outside the reading context
+	bool FillBuffer(GCodeBuffer *gb) noexcept override;			// Fill a GCodeBuffer with the next G-code, which may be a tokenized move
 
 	GCodeInputReadResult ReadFromFile(FileData &file) noexcept;	// Read another chunk of G-codes from the file and return true if more data is available
+	size_t FileBytesCached() const noexcept;					// How many bytes have been read from the file but not yet passed to the GCodeBuffer?
+	void Diagnostics(MessageType mtype) noexcept;
 
 private:
+	struct ReadAheadBuffer
+	{
+		size_t length;
+		size_t readPointer;
+		alignas(4) char data[FileReadAheadBufferSize];
+	};
+
+	void ClearReadAhead() noexcept;
+	bool ReadAhead(bool stalled) noexcept;
+	void TransferReadAheadData() noexcept;
+
+	bool CheckFileFormat(FileData &file) noexcept;
+
+#if SUPPORT_TOKENIZED_GCODE
+	bool FillBufferTokenized(GCodeBuffer *gb) noexcept;
+	bool ReadTokenizedMove(GCodeBuffer *gb) noexcept;
+	char PeekByte(size_t offset) const noexcept { return buffer[(readingPointer + offset) % GCodeInputBufferSize]; }
+#endif
+
 	FileStore *lastFile;
+	ReadAheadBuffer readAheadBuffers[NumFileReadAheadBuffers];
+	size_t firstFullBuffer;										// index of the read-ahead buffer we are passing to the ring buffer
+	size_t numFullBuffers;										// how many read-ahead buffers contain data
+	TimingHistogram readTiming;									// time taken by each file read
+	TimingHistogram stallTiming;								// time taken by file reads that the G-code parser had to wait for
+#if SUPPORT_TOKENIZED_GCODE
+	bool tokenized;												// true if the file we are reading is a tokenized file
+	bool atLineStart;											// true if the next byte starts a new line
+	bool fileEnded;												// true if the last read from the file returned no data
+#endif
 };
 
 #endif
@@ -14,12 +14,9 @@
 
 // GCodeQueue class
 
-GCodeQueue::GCodeQueue() noexcept : freeItems(nullptr), queuedItems(nullptr)
+GCodeQueue::GCodeQueue() noexcept
+	: readOffset(0), writeOffset(0), numQueued(0), bytesUsed(0), maxQueued(0), maxBytesUsed(0), timesFull(0), wasFull(false)
 {
-	for (size_t i = 0; i < maxQueuedCodes; i++)
-	{
-		freeItems = new QueuedCode(freeItems);
-	}
 }
 
 // Return true if the move in the GCodeBuffer should be queued
@@ -92,57 +89,115 @@ GCodeQueue::GCodeQueue() noexcept : freeItems(nullptr), queuedItems(nullptr)
 
 // Try to queue the command in the passed GCodeBuffer.
 // If successful, return true to indicate it has been queued.
-// If the queue is full or the command is too long to be queued, return false.
+// If there is not enough space in the arena to queue it, return false.
 bool GCodeQueue::QueueCode(GCodeBuffer &gb, uint32_t scheduleAt) noexcept
 {
-	// Can we queue this code somewhere?
-	if (freeItems == nullptr || gb.DataLength() > BufferSizePerQueueItem)
-	{
-		return false;
-	}
+	const size_t dataLength = gb.DataLength();
+	const size_t entrySize = EntrySize(dataLength);
 
-	// Unlink a free element and assign gb's code to it
-	QueuedCode * const code = freeItems;
-	freeItems = code->next;
-	code->AssignFrom(gb);
-	code->executeAtMove = scheduleAt;
-	code->next = nullptr;
-
-	// Append it to the list of queued codes
-	if (queuedItems == nullptr)
+	// Find space for the entry. If the queued entries don't wrap round the end of the arena then the free space is after them and also before them.
+	size_t offset;
+	if (numQueued == 0)
 	{
-		queuedItems = code;
+		readOffset = writeOffset = offset = 0;
+		if (entrySize > CodeQueueArenaSize)
+		{
+			return QueueFull();
+		}
 	}
-	else
+	else if (writeOffset > readOffset)
 	{
-		QueuedCode *last = queuedItems;
-		while (last->Next() != nullptr)
+		if (writeOffset + entrySize <= CodeQueueArenaSize)
 		{
-			last = last->Next();
+			offset = writeOffset;
 		}
-		last->next = code;
+		else if (entrySize <= readOffset)
+		{
+			// Tell the reader to go back to the start of the arena after the last entry, unless there isn't room for a header in which case it will do that anyway
+			if (writeOffset + sizeof(QueuedCodeHeader) <= CodeQueueArenaSize)
+			{
+				HeaderAt(writeOffset)->dataLength = WrapMarker;
+			}
+			offset = 0;
+		}
+		else
+		{
+			return QueueFull();
+		}
+	}
+	else if (writeOffset + entrySize <= readOffset)
+	{
+		offset = writeOffset;
+	}
+	else
+	{
+		return QueueFull();
 	}
 
+	QueuedCodeHeader * const header = HeaderAt(offset);
+	header->executeAtMove = scheduleAt;
+	header->dataLength = dataLength;
+#if HAS_LINUX_INTERFACE
+	header->isBinary = gb.IsBinary();
+#else
+	header->isBinary = false;
+#endif
+	memcpy(arena + offset + sizeof(QueuedCodeHeader), gb.DataStart(), dataLength);
+
+	writeOffset = offset + entrySize;
+	wasFull = false;
+	++numQueued;
+	bytesUsed += entrySize;
+	if (numQueued > maxQueued)
+	{
+		maxQueued = numQueued;
+	}
+	if (bytesUsed > maxBytesUsed)
+	{
+		maxBytesUsed = bytesUsed;
+	}
 	return true;
 }
 
+// Record that we couldn't queue a code. GCodes will keep trying to queue it, so we only count the first failure.
+bool GCodeQueue::QueueFull() noexcept
+{
+	if (!wasFull)
+	{
+		++timesFull;
+		wasFull = true;
+	}
+	return false;
+}
+
+// Return the offset of the entry at or after the specified offset, allowing for the writer having gone back to the start of the arena
+size_t GCodeQueue::NormaliseReadOffset(size_t offset) const noexcept
+{
+	return (offset + sizeof(QueuedCodeHeader) > CodeQueueArenaSize || HeaderAt(offset)->dataLength == WrapMarker) ? 0 : offset;
+}
+
 bool GCodeQueue::FillBuffer(GCodeBuffer *gb) noexcept
 {
 	// Can this buffer be filled?
-	if (queuedItems == nullptr || queuedItems->executeAtMove > reprap.GetMove().GetCompletedMoves())
+	if (IsIdle())
 	{
 		// No - stop here
 		return false;
 	}
 
 	// Yes - load it into the passed GCodeBuffer instance
-	QueuedCode *code = queuedItems;
-	code->AssignTo(gb);
+	const QueuedCodeHeader * const header = HeaderAt(readOffset);
+#if HAS_LINUX_INTERFACE
+	gb->PutAndDecode(arena + readOffset + sizeof(QueuedCodeHeader), header->dataLength, header->isBinary);
+#else
+	gb->PutAndDecode(arena + readOffset + sizeof(QueuedCodeHeader), header->dataLength);
+#endif
 
-	// Release this item again
-	queuedItems = queuedItems->next;
-	code->next = freeItems;
-	freeItems = code;
+	// Release this entry
+	const size_t entrySize = EntrySize(header->dataLength);
+	bytesUsed -= entrySize;
+	--numQueued;
+	readOffset = NormaliseReadOffset(readOffset + entrySize);
 	return true;
 }
 
@@ -160,95 +215,70 @@ size_t GCodeQueue::BytesCached() const noexcept
 // Return true if there is nothing to do
 bool GCodeQueue::IsIdle() const noexcept
 {
-	return queuedItems == nullptr || queuedItems->executeAtMove > reprap.GetMove().GetCompletedMoves();
+	return numQueued == 0 || HeaderAt(readOffset)->executeAtMove > reprap.GetMove().GetCompletedMoves();
 }
 
 // Because some moves may end before the print is actually paused, we need a method to
-// remove all the entries that will not be executed after the print has finally paused
+// remove all the entries that will not be executed after the print has finally paused.
+// Codes are queued in order of the moves they are synchronised to, so these entries are the newest ones.
 void GCodeQueue::PurgeEntries() noexcept
 {
-	QueuedCode *item = queuedItems, *lastItem = nullptr;
-	while (item != nullptr)
+	const uint32_t scheduledMoves = reprap.GetMove().GetScheduledMoves();
+	size_t offset = readOffset;
+	for (size_t i = 0; i < numQueued; ++i)
 	{
-		if (item->executeAtMove > reprap.GetMove().GetScheduledMoves())
-		{
-			// Release this item
-			QueuedCode *nextItem = item->Next();
-			item->next = freeItems;
-			freeItems = item;
-
-			// Unlink it from the list
-			if (lastItem == nullptr)
-			{
-				queuedItems = nextItem;
-			}
-			else
-			{
-				lastItem->next = nextItem;
-			}
-			item = nextItem;
-		}
-		else
+		const QueuedCodeHeader * const header = HeaderAt(offset);
+		if (header->executeAtMove > scheduledMoves)
 		{
-			lastItem = item;
-			item = item->Next();
+			// Discard this entry and all later ones
+			numQueued = i;
+			writeOffset = offset;
+			break;
 		}
+		offset = NormaliseReadOffset(offset + EntrySize(header->dataLength));
+	}
+
+	// Recalculate the space used
+	bytesUsed = 0;
+	offset = readOffset;
+	for (size_t i = 0; i < numQueued; ++i)
+	{
+		const size_t entrySize = EntrySize(HeaderAt(offset)->dataLength);
+		bytesUsed += entrySize;
+		offset = NormaliseReadOffset(offset + entrySize);
 	}
 }
 
 void GCodeQueue::Clear() noexcept
 {
-	while (queuedItems != nullptr)
-	{
-		QueuedCode * const item = queuedItems;
-		queuedItems = item->Next();
-		item->next = freeItems;
-		freeItems = item;
-	}
+	readOffset = writeOffset = numQueued = bytesUsed = 0;
 }
 
 void GCodeQueue::Diagnostics(MessageType mtype) noexcept
 {
-	reprap.GetPlatform().MessageF(mtype, "Code queue is %s\n", (queuedItems == nullptr) ? "empty." : "not empty:");
-	if (queuedItems != nullptr)
+	reprap.GetPlatform().MessageF(mtype, "Code queue is %s\n", (numQueued == 0) ? "empty." : "not empty:");
+	if (numQueued != 0)
 	{
-		const QueuedCode *item = queuedItems;
-		size_t queueLength = 0;
-		do
+		size_t offset = readOffset;
+		for (size_t i = 0; i < numQueued; ++i)
 		{
-			queueLength++;
+			const QueuedCodeHeader * const header = HeaderAt(offset);
 #if HAS_LINUX_INTERFACE
 			// The following may output binary gibberish if this code is stored in binary.
 			// We could restore this message by using GCodeBuffer::AppendFullCommand but there is probably no need to
-			if (!reprap.UsingLinuxInterface())
+			if (!header->isBinary)
 #endif
 			{
-				reprap.GetPlatform().MessageF(mtype, "Queued '%s' for move %" PRIu32 "\n", item->data, item->executeAtMove);
+				reprap.GetPlatform().MessageF(mtype, "Queued '%.*s' for move %" PRIu32 "\n", (int)header->dataLength, arena + offset + sizeof(QueuedCodeHeader), header->executeAtMove);
 			}
-		} while ((item = item->Next()) != nullptr);
-		reprap.GetPlatform().MessageF(mtype, "%d of %d codes have been queued.\n", queueLength, maxQueuedCodes);
+			offset = NormaliseReadOffset(offset + EntrySize(header->dataLength));
+		}
 	}
-}
-
-// QueuedCode class
-
-void QueuedCode::AssignFrom(GCodeBuffer &gb) noexcept
-{
-#if HAS_LINUX_INTERFACE
-	isBinary = gb.IsBinary();
-#endif
-	memcpy(data, gb.DataStart(), gb.DataLength());
-	dataLength = gb.DataLength();
-}
-
-void QueuedCode::AssignTo(GCodeBuffer *gb) noexcept
-{
-#if HAS_LINUX_INTERFACE
-	gb->PutAndDecode(data, dataLength, isBinary);
-#else
-	gb->PutAndDecode(data, dataLength);
-#endif
+	reprap.GetPlatform().MessageF(mtype, "Code queue: %u codes using %u of %u bytes, max %u codes using %u bytes, full %" PRIu32 " times\n",
+									numQueued, bytesUsed, CodeQueueArenaSize, maxQueued, maxBytesUsed, timesFull);
+	maxQueued = numQueued;
+	maxBytesUsed = bytesUsed;
+	timesFull = 0;
 }
 
 // End
-
@@ -10,10 +10,9 @@
 #include "RepRapFirmware.h"
 #include "GCodeInput.h"
 
-class QueuedCode;
-
-const size_t BufferSizePerQueueItem = SHORT_GCODE_LENGTH;
-
+// This class stores codes that must be executed when a particular move is reached, e.g. fan and laser commands.
+// The codes are held in a ring buffer arena of variable-length entries in the order in which they were queued, which is also the order of the moves they are synchronised to.
+// This lets us hold many more short codes than a fixed array of maximum-length codes would in the same RAM, and codes of any length can be queued.
 class GCodeQueue : public GCodeInput
 {
 public:
@@ -33,31 +32,32 @@ public:
 	static bool ShouldQueueCode(GCodeBuffer &gb) THROWS(GCodeException);	// Return true if this code should be queued
 
 private:
-	QueuedCode *freeItems;
-	QueuedCode *queuedItems;
-};
-
-class QueuedCode
-{
-public:
-	friend class GCodeQueue;
-
-	QueuedCode(QueuedCode *n) noexcept : next(n), dataLength(0) { }
-	QueuedCode *Next() const noexcept { return next; }
-
-private:
-	QueuedCode *next;
-
-#if HAS_LINUX_INTERFACE
-	bool isBinary;
-#endif
-	char data[BufferSizePerQueueItem];
-	size_t dataLength;
-
-	uint32_t executeAtMove;
-
-	void AssignFrom(GCodeBuffer &gb) noexcept;
-	void AssignTo(GCodeBuffer *gb) noexcept;
+	// Each entry in the arena is a header followed by the code, padded to a multiple of 4 bytes so that the next header is aligned
+	struct QueuedCodeHeader
+	{
+		uint32_t executeAtMove;
+		uint16_t dataLength;											// the length of the code, or WrapMarker
+		bool isBinary;
+	};
+
+	static constexpr uint16_t WrapMarker = 0xFFFF;						// dataLength value that means the next entry is at the start of the arena
+
+	static size_t EntrySize(size_t dataLength) noexcept { return sizeof(QueuedCodeHeader) + ((dataLength + 3u) & ~3u); }
+	QueuedCodeHeader *HeaderAt(size_t offset) noexcept { return reinterpret_cast<QueuedCodeHeader*>(arena + offset); }
+	const QueuedCodeHeader *HeaderAt(size_t offset) const noexcept { return reinterpret_cast<const QueuedCodeHeader*>(arena + offset); }
+	size_t NormaliseReadOffset(size_t offset) const noexcept;			// return the offset of the entry at or after 'offset', allowing for a wrap
+	bool QueueFull() noexcept;											// record that we couldn't queue a code and return false
+
+	size_t readOffset;													// offset of the oldest entry
+	size_t writeOffset;													// offset at which to store the next entry
+	size_t numQueued;													// number of codes queued
+	size_t bytesUsed;													// number of arena bytes used by queued entries, excluding unused space before a wrap
+	size_t maxQueued;													// high-water mark of numQueued since the last diagnostics report
+	size_t maxBytesUsed;												// high-water mark of bytesUsed since the last diagnostics report
+	uint32_t timesFull;													// how many times we couldn't queue a code because there was no space
+	bool wasFull;														// true if we failed to queue the last code we were asked to queue
+
+	alignas(4) char arena[CodeQueueArenaSize];
 };
 
 #endif
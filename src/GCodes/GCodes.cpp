@@ -213,6 +213,9 @@ void GCodes::Reset() noexcept
 	fileToPrint.Close();
 #endif
 	speedFactor = 1.0;
+	moveMergeTolerance = maxMergeDeviation = 0.0;
+	numMergedMoves = 0;
+	pendingMoveMergeable = mergingMove = false;
 
 	for (size_t i = 0; i < MaxExtruders; ++i)
 	{
@@ -1484,6 +1487,13 @@ void GCodes::Diagnostics(MessageType mtype) noexcept
 	}
 
 	codeQueue->Diagnostics(mtype);
+#if HAS_MASS_STORAGE
+	fileGCode->GetFileInput()->Diagnostics(mtype);
+#endif
+
+	platform.MessageF(mtype, "Merged G1 moves %" PRIu32 ", max deviation %.3fmm\n", numMergedMoves, (double)maxMergeDeviation);
+	numMergedMoves = 0;
+	maxMergeDeviation = 0.0;
 }
 
 // Lock movement and wait for pending moves to finish.
@@ -1703,9 +1713,61 @@ bool GCodes::CheckEnoughAxesHomed(AxesBitmap axesMoved) noexcept
 // If not ready, return false
 // If we can't execute the move, return true with 'err' set to the error message
 // Else return true with 'err' left alone (it is set to nullptr on entry)
-// We have already acquired the movement lock and waited for the previous move to be taken.
+// We have already acquired the movement lock and waited for the previous move to be taken, unless CanMergeStraightMove set mergingMove.
 bool GCodes::DoStraightMove(GCodeBuffer& gb, bool isCoordinated, const char *& err)
 {
+	if (!mergingMove)
+	{
+		return SetUpStraightMove(gb, isCoordinated, nullptr, err);
+	}
+
+	// We are merging this command into the move that is waiting in moveBuffer. Take that move back from the Move task first, so that it can't be executed while we change it.
+	// If the Move task took it since we checked, set up a separate move instead.
+	mergingMove = false;
+	bool gotPendingMove;
+	{
+		TaskCriticalSectionLocker lock;
+		gotPendingMove = (segmentsLeft == 1);
+		if (gotPendingMove)
+		{
+			segmentsLeft = 0;
+		}
+	}
+	if (!gotPendingMove)
+	{
+		return SetUpStraightMove(gb, isCoordinated, nullptr, err);
+	}
+
+	// If we can't merge the command, put the pending move back unchanged so that it still gets executed
+	const RawMove pendingMove = moveBuffer;
+	bool done;
+	try
+	{
+		done = SetUpStraightMove(gb, isCoordinated, &pendingMove, err);
+	}
+	catch (const GCodeException&)
+	{
+		moveBuffer = pendingMove;
+		NewMoveAvailable(1);
+		throw;
+	}
+	if (!done || err != nullptr)
+	{
+		moveBuffer = pendingMove;
+		NewMoveAvailable(1);
+	}
+	return done;
+}
+
+// Set up a straight move. This is the body of DoStraightMove, and the return value and 'err' have the same meaning.
+// If pendingMove is not null then it is the move that was waiting in moveBuffer, and we merge the new move into it.
+// On any early return the caller restores moveBuffer from pendingMove.
+bool GCodes::SetUpStraightMove(GCodeBuffer& gb, bool isCoordinated, const RawMove *pendingMove, const char *& err)
+{
+	const bool merging = (pendingMove != nullptr);
+	float unusedXY[2], requestedExtrusion = 0.0;
+	const bool mergeable = isCoordinated && GetMergeableMoveParameters(gb, unusedXY, requestedExtrusion);
+
 	if (moveFractionToSkip > 0.0)
 	{
 		moveBuffer.initialUserX = restartInitialUserX;
@@ -2036,13 +2098,220 @@ bool GCodes::DoStraightMove(GCodeBuffer& gb, bool isCoordinated, const char *& e
 		}
 	}
 
+	if (merging)
+	{
+		// Make the move start where the move that was waiting started, and add that move's extrusion to ours
+		memcpy(moveBuffer.initialCoords, pendingMove->initialCoords, numVisibleAxes * sizeof(moveBuffer.initialCoords[0]));
+		moveBuffer.initialUserX = pendingMove->initialUserX;
+		moveBuffer.initialUserY = pendingMove->initialUserY;
+		moveBuffer.virtualExtruderPosition = pendingMove->virtualExtruderPosition;
+		for (size_t extruder = 0; extruder < numExtruders; ++extruder)
+		{
+			moveBuffer.coords[ExtruderToLogicalDrive(extruder)] += pendingMove->coords[ExtruderToLogicalDrive(extruder)];
+		}
+
+		mergePointsXY[numMergePoints][0] = initialXY[0];
+		mergePointsXY[numMergePoints][1] = initialXY[1];
+		++numMergePoints;
+		mergeXYLength += sqrtf(fsquare(currentUserPosition[X_AXIS] - initialXY[0]) + fsquare(currentUserPosition[Y_AXIS] - initialXY[1]));
+		mergeRequestedExtrusion += requestedExtrusion;
+		++numMergedMoves;
+		if (mergeDeviation > maxMergeDeviation)
+		{
+			maxMergeDeviation = mergeDeviation;
+		}
+	}
+	else
+	{
+		// Remember whether a following G1 command may be merged into this move
+		pendingMoveMergeable = mergeable && moveBuffer.moveType == 0 && moveBuffer.isCoordinated && totalSegments == 1;
+		mergeStartXY[0] = initialXY[0];
+		mergeStartXY[1] = initialXY[1];
+		numMergePoints = 0;
+		mergeXYLength = sqrtf(fsquare(currentUserPosition[X_AXIS] - initialXY[0]) + fsquare(currentUserPosition[Y_AXIS] - initialXY[1]));
+		mergeRequestedExtrusion = requestedExtrusion;
+	}
+
 	doingArcMove = false;
+	mergingMove = merging;						// tell FinaliseMove to leave the file position alone
 	FinaliseMove(gb);
+	mergingMove = false;
 	UnlockAll(gb);			// allow pause
 	err = nullptr;
 	return true;
 }
 
+// Check whether a G1 command is a simple XY move that could be merged with an adjacent one.
+// If it is, return true with the target user XY coordinates and the amount of extrusion requested, before applying mixing and extrusion factors.
+// This must not change any state, because it is called before the command is executed.
+bool GCodes::GetMergeableMoveParameters(GCodeBuffer& gb, float targetXY[2], float& requestedExtrusion) THROWS(GCodeException)
+{
+	if (   moveMergeTolerance <= 0.0 || &gb != fileGCode || gb.IsDoingFileMacro() || moveFractionToSkip != 0.0
+		|| gb.Seen('H') || gb.Seen('R') || gb.Seen('S') || gb.Seen('P')
+	   )
+	{
+		return false;
+	}
+
+	for (size_t axis = 0; axis < numVisibleAxes; ++axis)
+	{
+		if (axis != X_AXIS && axis != Y_AXIS && gb.Seen(axisLetters[axis]))
+		{
+			return false;
+		}
+	}
+
+	bool seenXY = false;
+	for (size_t axis = X_AXIS; axis <= Y_AXIS; ++axis)
+	{
+		targetXY[axis] = currentUserPosition[axis];
+		if (gb.Seen(axisLetters[axis]))
+		{
+			seenXY = true;
+			const float moveArg = gb.GetDistance();
+			targetXY[axis] = (gb.MachineState().axesRelative) ? currentUserPosition[axis] + moveArg
+								: (gb.MachineState().g53Active) ? moveArg + GetCurrentToolOffset(axis)
+									: moveArg + GetWorkplaceOffset(axis);
+		}
+	}
+	if (!seenXY)
+	{
+		return false;
+	}
+
+	if (gb.Seen(feedrateLetter) && gb.GetDistance() * SecondsToMinutes != gb.MachineState().feedRate)
+	{
+		return false;												// the speed changes, so keep the moves separate
+	}
+
+	requestedExtrusion = 0.0;
+	if (gb.Seen(extrudeLetter))
+	{
+		if (reprap.GetCurrentTool() == nullptr)
+		{
+			return false;
+		}
+		float eMovement[MaxExtruders];
+		size_t mc = MaxExtruders;
+		gb.GetFloatArray(eMovement, mc, false);
+		if (mc != 1)
+		{
+			return false;
+		}
+		const float moveArg = gb.ConvertDistance(eMovement[0]);
+		requestedExtrusion = (gb.MachineState().drivesRelative) ? moveArg : moveArg - virtualExtruderPosition;
+		if (requestedExtrusion <= 0.0)
+		{
+			return false;											// don't merge retractions or moves that were only given an E parameter to keep the slicer happy
+		}
+	}
+	return true;
+}
+
+// Check whether a G1 command can be merged with the move that is waiting in moveBuffer to be taken by the Move module.
+// We can merge them if the straight line from the start of the waiting move to the end of the new one passes within moveMergeTolerance of all the intermediate points,
+// and the extrusion per mm is about the same. If we can, set mergingMove and mergeDeviation.
+bool GCodes::CanMergeStraightMove(GCodeBuffer& gb) THROWS(GCodeException)
+{
+	if (   !pendingMoveMergeable || segmentsLeft != 1 || totalSegments != 1 || numMergePoints >= MaxMergedMovePoints
+		|| moveBuffer.tool != reprap.GetCurrentTool() || buildObjects.IsFirstMoveSincePrintingResumed()
+		|| reprap.GetMove().GetKinematics().UseSegmentation()
+	   )
+	{
+		return false;
+	}
+
+	float targetXY[2], requestedExtrusion;
+	if (!GetMergeableMoveParameters(gb, targetXY, requestedExtrusion) || (requestedExtrusion > 0.0) != moveBuffer.hasExtrusion)
+	{
+		return false;
+	}
+
+	const float dx = targetXY[0] - mergeStartXY[0], dy = targetXY[1] - mergeStartXY[1];
+	const float newLengthSquared = fsquare(dx) + fsquare(dy);
+	if (newLengthSquared <= 0.0)
+	{
+		return false;
+	}
+	if (reprap.GetMove().IsUsingMesh() && reprap.GetMove().AccessHeightMap().GetMinimumSegments(dx, dy) > 1)
+	{
+		return false;												// the merged move would need to be segmented
+	}
+
+	// We check the deviation against the requested target, so don't merge if the target would be limited or the merged move is not reachable
+	{
+		float targetUserPosition[MaxAxes];
+		memcpy(targetUserPosition, currentUserPosition, sizeof(targetUserPosition));
+		targetUserPosition[X_AXIS] = targetXY[0];
+		targetUserPosition[Y_AXIS] = targetXY[1];
+		float targetCoords[MaxAxesPlusExtruders];
+		memcpy(targetCoords, moveBuffer.coords, sizeof(targetCoords));
+		ToolOffsetTransform(targetUserPosition, targetCoords, XyAxes);
+		AxesBitmap effectiveAxesHomed = axesHomed;
+		if (doingManualBedProbe)
+		{
+			effectiveAxesHomed.ClearBit(Z_AXIS);
+		}
+		if (reprap.GetMove().GetKinematics().LimitPosition(targetCoords, moveBuffer.initialCoords, numVisibleAxes, effectiveAxesHomed, true, limitAxes) != LimitPositionResult::ok)
+		{
+			return false;
+		}
+	}
+
+	// Check that the extrusion per mm of the new move matches the extrusion per mm of the moves merged so far
+	const float newXYLength = sqrtf(fsquare(targetXY[0] - currentUserPosition[X_AXIS]) + fsquare(targetXY[1] - currentUserPosition[Y_AXIS]));
+	if (   newXYLength <= 0.0 || mergeXYLength <= 0.0
+		|| fabsf(requestedExtrusion * mergeXYLength - mergeRequestedExtrusion * newXYLength) > MaxMergeExtrusionRateError * mergeRequestedExtrusion * newXYLength
+	   )
+	{
+		return false;
+	}
+
+	// Check that all the junction points lie close to the new line and in order along it
+	const float newLength = sqrtf(newLengthSquared);
+	float lastProjection = 0.0;
+	float deviation = 0.0;
+	for (size_t i = 0; i <= numMergePoints; ++i)
+	{
+		const float px = ((i == numMergePoints) ? currentUserPosition[X_AXIS] : mergePointsXY[i][0]) - mergeStartXY[0];
+		const float py = ((i == numMergePoints) ? currentUserPosition[Y_AXIS] : mergePointsXY[i][1]) - mergeStartXY[1];
+		const float projection = (px * dx + py * dy)/newLength;
+		if (projection <= lastProjection || projection >= newLength)
+		{
+			return false;
+		}
+		lastProjection = projection;
+		deviation = max<float>(deviation, fabsf(px * dy - py * dx)/newLength);
+		if (deviation > moveMergeTolerance)
+		{
+			return false;
+		}
+	}
+
+	mergeDeviation = deviation;
+	mergingMove = true;
+	return true;
+}
+
+// Handle M597
+GCodeResult GCodes::ConfigureMoveMerging(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
+{
+	if (gb.Seen('S'))
+	{
+		moveMergeTolerance = max<float>(gb.GetFValue(), 0.0);
+	}
+	else if (moveMergeTolerance <= 0.0)
+	{
+		reply.copy("G1 move merging is disabled");
+	}
+	else
+	{
+		reply.printf("G1 moves are merged if the path deviates by no more than %.3fmm, %" PRIu32 " merged since last report, max deviation %.3fmm",
+						(double)moveMergeTolerance, numMergedMoves, (double)maxMergeDeviation);
+	}
+	return GCodeResult::ok;
+}
+
 // Execute an arc move
 // We already have the movement lock and the last move has gone
 // Currently, we do not process new babystepping when executing an arc move
@@ -2344,6 +2613,13 @@ bool GCodes::DoArcMove(GCodeBuffer& gb, bool clockwise, const char *& err)
 		arcAngleIncrement = -arcAngleIncrement;
 	}
 
+	// Calculating the sine and cosine for every segment is slow on processors without an FPU, so we rotate the previous position by the segment angle instead
+	arcCurrentSin = sinf(arcCurrentAngle);
+	arcCurrentCos = cosf(arcCurrentAngle);
+	arcIncrementSin = sinf(arcAngleIncrement);
+	arcIncrementCos = cosf(arcAngleIncrement);
+	arcSegmentsTillCorrection = ArcCorrectionSegments;
+
 	doingArcMove = true;
 	FinaliseMove(gb);
 	UnlockAll(gb);			// allow pause
@@ -2356,7 +2632,10 @@ bool GCodes::DoArcMove(GCodeBuffer& gb, bool clockwise, const char *& err)
 void GCodes::FinaliseMove(GCodeBuffer& gb) noexcept
 {
 	moveBuffer.canPauseAfter = !moveBuffer.checkEndstops && !doingArcMove;		// pausing during an arc move isn't safe because the arc centre get recomputed incorrectly when we resume
-	moveBuffer.filePos = (&gb == fileGCode) ? gb.GetFilePosition() : noFilePosition;
+	if (!mergingMove)
+	{
+		moveBuffer.filePos = (&gb == fileGCode) ? gb.GetFilePosition() : noFilePosition;	// a merged move keeps the position of its first command so that we can resume it after a pause
+	}
 	gb.MotionCommanded();
 
 	if (buildObjects.IsCurrentObjectCancelled())
@@ -2455,6 +2734,20 @@ bool GCodes::ReadMove(RawMove& m) noexcept
 		if (doingArcMove)
 		{
 			arcCurrentAngle += arcAngleIncrement;
+			--arcSegmentsTillCorrection;
+			if (arcSegmentsTillCorrection == 0)
+			{
+				// Recalculate the position exactly from time to time, so that rounding errors in the rotation don't accumulate
+				arcCurrentSin = sinf(arcCurrentAngle);
+				arcCurrentCos = cosf(arcCurrentAngle);
+				arcSegmentsTillCorrection = ArcCorrectionSegments;
+			}
+			else
+			{
+				const float newSin = arcCurrentSin * arcIncrementCos + arcCurrentCos * arcIncrementSin;
+				arcCurrentCos = arcCurrentCos * arcIncrementCos - arcCurrentSin * arcIncrementSin;
+				arcCurrentSin = newSin;
+			}
 		}
 
 		for (size_t drive = 0; drive < numVisibleAxes; ++drive)
@@ -2462,12 +2755,12 @@ bool GCodes::ReadMove(RawMove& m) noexcept
 			if (doingArcMove && drive != Z_AXIS && Tool::GetYAxes(moveBuffer.tool).IsBitSet(drive))
 			{
 				// Y axis or a substitute Y axis
-				moveBuffer.initialCoords[drive] = arcCentre[drive] + arcRadius * axisScaleFactors[drive] * sinf(arcCurrentAngle);
+				moveBuffer.initialCoords[drive] = arcCentre[drive] + arcRadius * axisScaleFactors[drive] * arcCurrentSin;
 			}
 			else if (doingArcMove && drive != Z_AXIS && Tool::GetXAxes(moveBuffer.tool).IsBitSet(drive))
 			{
 				// X axis or a substitute X axis
-				moveBuffer.initialCoords[drive] = arcCentre[drive] + arcRadius * axisScaleFactors[drive] * cosf(arcCurrentAngle);
+				moveBuffer.initialCoords[drive] = arcCentre[drive] + arcRadius * axisScaleFactors[drive] * arcCurrentCos;
 			}
 			else
 			{
@@ -2521,6 +2814,7 @@ void GCodes::ClearMove() noexcept
 	moveBuffer.moveType = 0;
 	moveBuffer.applyM220M221 = false;
 	moveFractionToSkip = 0.0;
+	pendingMoveMergeable = false;
 }
 
 // Cancel any macro or print in progress
@@ -2989,6 +3283,7 @@ bool GCodes::QueueFileToPrint(const char* fileName, const StringRef& reply) noex
 	FileStore * const f = platform.OpenFile(platform.GetGCodeDir(), fileName, OpenMode::read);
 	if (f != nullptr)
 	{
+		(void)f->EnableFastSeek();									// so that M26 and pausing and resuming don't need to walk the FAT chain
 		fileToPrint.Set(f);
 		fileOffsetToPrint = 0;
 		restartMoveFractionDone = 0.0;
@@ -246,6 +246,8 @@ public:
 # endif
 #endif
 
+	static bool IsWholeLineCommentOfInterest(const char *text) noexcept;		// Return true if ProcessWholeLineComment would act on this comment text
+
 	static constexpr const char *AllowedAxisLetters = "XYZUVWABCD";
 
 	// Standard macro filenames
@@ -322,9 +324,13 @@ private:
 	void HandleReplyPreserveResult(GCodeBuffer& gb, GCodeResult rslt, const char *reply) noexcept;	// Handle G-Code replies
 
 	bool DoStraightMove(GCodeBuffer& gb, bool isCoordinated, const char *& err) __attribute__((hot));	// Execute a straight move
+	bool SetUpStraightMove(GCodeBuffer& gb, bool isCoordinated, const RawMove *pendingMove, const char *& err) __attribute__((hot));	// Set up a straight move, merging it with pendingMove if not null
 	bool DoArcMove(GCodeBuffer& gb, bool clockwise, const char *& err)				// Execute an arc move
 		pre(segmentsLeft == 0; resourceOwners[MoveResource] == &gb);
 	void FinaliseMove(GCodeBuffer& gb) noexcept;									// Adjust the move parameters to account for segmentation and/or part of the move having been done already
+	bool GetMergeableMoveParameters(GCodeBuffer& gb, float targetXY[2], float& requestedExtrusion) THROWS(GCodeException);	// Check whether a G1 command is simple enough to be merged with another one
+	bool CanMergeStraightMove(GCodeBuffer& gb) THROWS(GCodeException);			// Check whether a G1 command can be merged with the move that is waiting to be taken
+	GCodeResult ConfigureMoveMerging(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException);	// Handle M597
 	bool CheckEnoughAxesHomed(AxesBitmap axesMoved) noexcept;						// Check that enough axes have been homed
 	bool TravelToStartPoint(GCodeBuffer& gb) noexcept;								// Set up a move to travel to the resume point
 
@@ -523,8 +529,23 @@ private:
 	float arcRadius;
 	float arcCurrentAngle;
 	float arcAngleIncrement;
+	float arcCurrentSin, arcCurrentCos;			// sine and cosine of arcCurrentAngle
+	float arcIncrementSin, arcIncrementCos;		// sine and cosine of arcAngleIncrement
+	unsigned int arcSegmentsTillCorrection;		// how many more segments we generate by rotation before we recalculate arcCurrentSin and arcCurrentCos exactly
 	bool doingArcMove;
 
+	float moveMergeTolerance;					// how far a merged move may deviate from the original path, or zero if merging is disabled
+	float mergeStartXY[2];						// the user X and Y coordinates at the start of the move waiting in moveBuffer
+	float mergePointsXY[MaxMergedMovePoints][2];	// the junctions between the G1 moves that have been merged into the move waiting in moveBuffer
+	float mergeXYLength;						// the XY length of the G1 moves that have been merged into the move waiting in moveBuffer
+	float mergeRequestedExtrusion;				// the extrusion requested by those G1 moves
+	float mergeDeviation;						// the deviation from the original path if the move being processed is merged
+	float maxMergeDeviation;					// the largest deviation we have introduced since the last diagnostics report
+	uint32_t numMergedMoves;					// how many G1 moves have been merged into their predecessors since the last diagnostics report
+	unsigned int numMergePoints;				// how many entries of mergePointsXY are in use
+	bool pendingMoveMergeable;					// true if the move waiting in moveBuffer is a simple G1 move that we may extend
+	bool mergingMove;							// true while DoStraightMove is merging a G1 command into the move waiting in moveBuffer
+
 	enum class SegmentedMoveState : uint8_t
 	{
 		inactive = 0,
@@ -76,6 +76,12 @@ bool GCodes::ActOnCode(GCodeBuffer& gb, const StringRef& reply) noexcept
 			return false;		// we should queue this code but we can't, so wait until we can either execute it or queue it
 		}
 
+		// Only consecutive G1 commands from the file being printed may be merged
+		if (&gb == fileGCode && (gb.GetCommandLetter() != 'G' || gb.GetCommandNumber() != 1))
+		{
+			pendingMoveMergeable = false;
+		}
+
 		switch (gb.GetCommandLetter())
 		{
 		case 'G':
@@ -132,10 +138,14 @@ bool GCodes::HandleGcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 	case 1: // Ordinary move
 		if (segmentsLeft != 0)			// do this check first to avoid locking movement unnecessarily
 		{
-			return false;
+			if (code != 1 || !CanMergeStraightMove(gb))
+			{
+				return false;
+			}
 		}
 		if (!LockMovement(gb))
 		{
+			mergingMove = false;
 			return false;
 		}
 		{
@@ -2642,6 +2652,13 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 				bool dummy;
 				gb.TryGetQuotedString('K', key.GetRef(), dummy);
 				gb.TryGetQuotedString('F', flags.GetRef(), dummy);
+				if (ObjectModel::IsBinaryReport(flags.c_str()))
+				{
+					// The reply is sent as a text message, so it can't hold binary data
+					reply.copy("binary object model reports are only available from rr_model and the SBC interface");
+					result = GCodeResult::error;
+					break;
+				}
 				outBuf = reprap.GetModelResponse(key.c_str(), flags.c_str());
 				if (outBuf == nullptr)
 				{
@@ -3550,6 +3567,22 @@ bool GCodes::HandleMcode(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeEx
 			break;
 #endif
 
+		case 595:	// Configure movement queue
+			if ((gb.Seen('P') || gb.Seen('S')) && !LockMovementAndWaitForStandstill(gb))	// a query doesn't need to wait for the machine to stop
+			{
+				return false;
+			}
+			result = reprap.GetMove().ConfigureMovementQueue(gb, reply);
+			break;
+
+		case 596:	// Select step time calculation method
+			result = reprap.GetMove().ConfigureStepGeneration(gb, reply);
+			break;
+
+		case 597:	// Configure merging of G1 moves
+			result = ConfigureMoveMerging(gb, reply);
+			break;
+
 		// For cases 600 and 601, see 226
 
 		// M650 (set peel move parameters) and M651 (execute peel move) are no longer handled specially. Use macros to specify what they should do.
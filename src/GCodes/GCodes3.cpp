@@ -1393,100 +1393,111 @@ void GCodes::RetractZProbe(GCodeBuffer& gb, int code) noexcept
 	}
 }
 
-// Process a whole-line comment returning true if completed
-bool GCodes::ProcessWholeLineComment(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
+// Whole-line comments that start with one of these strings followed by a space or colon tell us something about the print
+static const char * const CommentKeywords[] =
+{
+	"printing object",			// slic3r
+	"MESH",						// Cura
+	"process",					// S3D
+	"stop printing object",		// slic3r
+	"layer",					// S3D "; layer 1, z=0.200"
+	"LAYER",					// Ideamaker, Cura (followed by layer number starting at zero)
+	"BEGIN_LAYER_OBJECT z=",	// KISSlicer (followed by Z height)
+	"HEIGHT"					// Ideamaker
+};
+
+// If the comment text starts with one of the keywords, advance the text pointer past the keyword and following separators and return the index of the keyword, else return -1
+static int FindCommentKeyword(const char *&text) noexcept
 {
-	static const char * const StartStrings[] =
-	{
-		"printing object",			// slic3r
-		"MESH",						// Cura
-		"process",					// S3D
-		"stop printing object",		// slic3r
-		"layer",					// S3D "; layer 1, z=0.200"
-		"LAYER",					// Ideamaker, Cura (followed by layer number starting at zero)
-		"BEGIN_LAYER_OBJECT z=",	// KISSlicer (followed by Z height)
-		"HEIGHT"					// Ideamaker
-	};
-
-	String<StringLength100> comment;
-	gb.GetCompleteParameters(comment.GetRef());
-	const char *text = comment.c_str();
 	while (*text == ' ')
 	{
 		++text;
 	}
 
-	for (size_t i = 0; i < ARRAY_SIZE(StartStrings); ++i)
+	for (size_t i = 0; i < ARRAY_SIZE(CommentKeywords); ++i)
 	{
-		if (StringStartsWith(text, StartStrings[i]))
+		const size_t len = strlen(CommentKeywords[i]);
+		if (StringStartsWith(text, CommentKeywords[i]) && (text[len] == ' ' || text[len] == ':'))	// need this test to avoid recognising "processName" as "process"
 		{
-			text += strlen(StartStrings[i]);
-			if (*text == ' ' || *text == ':')			// need this test to avoid recognising "processName" as "process"
+			text += len;
+			do
 			{
-				do
-				{
-					++text;
-				}
-				while (*text == ' ' || *text == ':');
+				++text;
+			}
+			while (*text == ' ' || *text == ':');
+			return (int)i;
+		}
+	}
+	return -1;
+}
 
-				switch (i)
-				{
-				case 1:		// MESH (Cura)
+// Return true if ProcessWholeLineComment would act on this comment text. This lets the G-code reader discard other comments without passing them to us.
+/*static*/ bool GCodes::IsWholeLineCommentOfInterest(const char *text) noexcept
+{
+	return FindCommentKeyword(text) >= 0;
+}
+
+// Process a whole-line comment returning true if completed
+bool GCodes::ProcessWholeLineComment(GCodeBuffer& gb, const StringRef& reply) THROWS(GCodeException)
+{
+	String<StringLength100> comment;
+	gb.GetCompleteParameters(comment.GetRef());
+	const char *text = comment.c_str();
+	const int i = FindCommentKeyword(text);
+	switch (i)
+	{
+	case 1:		// MESH (Cura)
 #if TRACK_OBJECT_NAMES
-					if (StringStartsWith(text, "NONMESH"))
-					{
-						buildObjects.StopObject(gb);
-						break;
-					}
+		if (StringStartsWith(text, "NONMESH"))
+		{
+			buildObjects.StopObject(gb);
+			break;
+		}
 #endif
-					// no break
-				case 0:		// printing object (slic3r)
-				case 2:		// process (S3D)
+		// no break
+	case 0:		// printing object (slic3r)
+	case 2:		// process (S3D)
 #if TRACK_OBJECT_NAMES
-					buildObjects.StartObject(gb, text);
+		buildObjects.StartObject(gb, text);
 #endif
-					break;
+		break;
 
 
-				case 3:		// stop printing object
+	case 3:		// stop printing object
 #if TRACK_OBJECT_NAMES
-					buildObjects.StopObject(gb);
+		buildObjects.StopObject(gb);
 #endif
-					break;
-
-				case 4:		// layer (counting from 1)
-				case 5:		// layer (counting from 0)
-					{
-						const char *endptr;
-						const uint32_t layer = StrToU32(text, &endptr);
-						if (endptr != text)
-						{
-							reprap.GetPrintMonitor().SetLayerNumber((i == 5) ? layer + 1 : layer);
-						}
-						text = endptr;
-						if (!StringStartsWith(text, ", z = "))		// S3D gives us the height too
-						{
-							break;
-						}
-						text += 6;			// skip ", z = "
-					}
-					// no break
+		break;
 
-				case 6:		// new layer, but we are given the Z height, not the layer number
-				case 7:
-					{
-						const char *endptr;
-						const float layerZ = SafeStrtof(text, &endptr);
-						if (endptr != text)
-						{
-							reprap.GetPrintMonitor().SetLayerZ(layerZ);
-						}
-					}
-					break;
-				}
+	case 4:		// layer (counting from 1)
+	case 5:		// layer (counting from 0)
+		{
+			const char *endptr;
+			const uint32_t layer = StrToU32(text, &endptr);
+			if (endptr != text)
+			{
+				reprap.GetPrintMonitor().SetLayerNumber((i == 5) ? layer + 1 : layer);
+			}
+			text = endptr;
+			if (!StringStartsWith(text, ", z = "))		// S3D gives us the height too
+			{
 				break;
 			}
+			text += 6;			// skip ", z = "
 		}
+		// no break
+
+	case 6:		// new layer, but we are given the Z height, not the layer number
+	case 7:
+		{
+			const char *endptr;
+			const float layerZ = SafeStrtof(text, &endptr);
+			if (endptr != text)
+			{
+				reprap.GetPrintMonitor().SetLayerZ(layerZ);
+			}
+		}
+		break;
 	}
 	return true;
 }
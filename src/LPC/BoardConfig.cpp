@@ -212,6 +212,20 @@ void BoardConfig::Init() noexcept
                 }
             }
         }
+
+        //Calculate the per-port step pin masks (used to step drivers on different ports with one write per port)
+        for(size_t port=0; port<NumGpioPorts; port++)
+        {
+            STEP_PORT_MASKS[port] = 0;
+        }
+        for(size_t i=0; i<MaxTotalDrivers; i++)
+        {
+            const Pin stepPin = STEP_PINS[i];
+            if(stepPin != NoPin && (stepPin >> 5) < NumGpioPorts)
+            {
+                STEP_PORT_MASKS[stepPin >> 5] |= (1 << (stepPin & 0x1f));
+            }
+        }
         
         //Does board have build in current control via digipots?
         if(digipotFactor > 1)
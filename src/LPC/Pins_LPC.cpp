@@ -46,6 +46,8 @@ Pin STEP_PINS[NumDirectDrivers] =       {NoPin, NoPin, NoPin, NoPin, NoPin};
 Pin DIRECTION_PINS[NumDirectDrivers] =  {NoPin, NoPin, NoPin, NoPin, NoPin};
 uint32_t STEP_DRIVER_MASK = 0;                          //SD: mask of the step pins on Port 2 used for writing to step pins in parallel
 bool hasStepPinsOnDifferentPorts = false;               //for boards that don't have all step pins on port2
+uint32_t STEP_PORT_MASKS[NumGpioPorts] = {0, 0, 0, 0, 0}; //masks of the step pins on each port, used when the step pins are on different ports
+decltype(LPC_GPIO0) const GPIO_PORTS[NumGpioPorts] = {LPC_GPIO0, LPC_GPIO1, LPC_GPIO2, LPC_GPIO3, LPC_GPIO4};
 bool hasDriverCurrentControl = false;                   //Supports digipots to set stepper current
 float digipotFactor = 0.0;                              //defualt factor for converting current to digipot value
 
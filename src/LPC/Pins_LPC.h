@@ -144,6 +144,9 @@ extern Pin STEP_PINS[NumDirectDrivers];
 extern Pin DIRECTION_PINS[NumDirectDrivers];
 extern uint32_t STEP_DRIVER_MASK; // Mask for parallel write to all steppers on port 2 (calculated in after loading board.txt)
 extern bool hasStepPinsOnDifferentPorts;
+constexpr size_t NumGpioPorts = 5;
+extern uint32_t STEP_PORT_MASKS[NumGpioPorts]; // Masks of the step pins on each port (calculated after loading board.txt)
+extern decltype(LPC_GPIO0) const GPIO_PORTS[NumGpioPorts];
 extern bool hasDriverCurrentControl;
 extern float digipotFactor;
 
@@ -414,15 +417,17 @@ namespace StepPins
         if(hasStepPinsOnDifferentPorts == true )
         {
             //Using driver pos in bitmap to match position in STEP_PINS
-            uint8_t pos=0;
-            while (driverMap!=0 && pos < NumDirectDrivers)
+            //Gather the step bits for each port so that all the drivers on the same port are stepped with a single write
+            uint32_t portBits[NumGpioPorts] = {0, 0, 0, 0, 0};
+            while (driverMap != 0)
             {
-                if(driverMap & 0x01)
-                {
-                    if(STEP_PINS[pos] != NoPin) GPIO_PinWrite(STEP_PINS[pos], 1); //set high
-                }
-                driverMap = driverMap >> 1;
-                pos++;
+                const Pin stepPin = STEP_PINS[__builtin_ctz(driverMap)];    //CalcDriverBitmap never sets a bit for a driver without a step pin
+                driverMap &= driverMap - 1;
+                portBits[stepPin >> 5] |= 1u << (stepPin & 0x1f);
+            }
+            for(size_t port=0; port<NumGpioPorts; port++)
+            {
+                if(portBits[port] != 0) GPIO_PORTS[port]->SET = portBits[port]; //set high
             }
         }
         else
@@ -434,14 +439,14 @@ namespace StepPins
     
     // Set all step pins low
     // This needs to be as fast as possible, so we do a parallel write to the port(s).
-    // We rely on only those port bits that are step pins being set in the STEP_DRIVER_MASK variable
+    // We rely on only those port bits that are step pins being set in the STEP_DRIVER_MASK and STEP_PORT_MASKS variables
     static inline void StepDriversLow() noexcept
     {
         if(hasStepPinsOnDifferentPorts == true )
         {
-            for(size_t d=0; d<NumDirectDrivers; d++)
+            for(size_t port=0; port<NumGpioPorts; port++)
             {
-                if(STEP_PINS[d] != NoPin) GPIO_PinWrite(STEP_PINS[d], 0); //set low
+                if(STEP_PORT_MASKS[port] != 0) GPIO_PORTS[port]->CLR = STEP_PORT_MASKS[port]; //set low
             }
         }
         else
@@ -1052,22 +1052,20 @@ pre(disableDeltaMapping || drive < MaxAxes)
 // This is only called once, so inlined for speed
 inline void DDA::AdjustAcceleration() noexcept
 {
-	// Try to reduce the acceleration/deceleration of the move to cancel ringing
-	const float idealPeriod = reprap.GetMove().GetDRCperiod();
+	// Try to reduce the acceleration/deceleration of the move to cancel ringing.
+	// A period of constant acceleration that lasts a whole number of ringing periods leaves no residual ringing, so we stretch short acceleration and deceleration phases to that.
+	const float idealPeriod = reprap.GetMove().GetDRCdampedPeriod();
+	const float maxPeriods = (float)reprap.GetMove().GetDRCmaxPeriods();
 
 	float proposedAcceleration = acceleration, proposedAccelDistance = beforePrepare.accelDistance;
 	bool adjustAcceleration = false;
 	if ((prev->state != DDAState::frozen && prev->state != DDAState::executing) || !prev->IsAccelerationMove())
 	{
 		const float accelTime = (topSpeed - startSpeed)/acceleration;
-		if (accelTime < idealPeriod)
+		if (accelTime < idealPeriod * maxPeriods)
 		{
-			proposedAcceleration = (topSpeed - startSpeed)/idealPeriod;
-			adjustAcceleration = true;
-		}
-		else if (accelTime < idealPeriod * 2)
-		{
-			proposedAcceleration = (topSpeed - startSpeed)/(idealPeriod * 2);
+			// Stretch the acceleration to the next whole number of ringing periods
+			proposedAcceleration = (topSpeed - startSpeed)/(idealPeriod * ceilf(accelTime/idealPeriod));
 			adjustAcceleration = true;
 		}
 		if (adjustAcceleration)
@@ -1081,14 +1079,9 @@ inline void DDA::AdjustAcceleration() noexcept
 	if (next->state != DDAState::provisional || !next->IsDecelerationMove())
 	{
 		const float decelTime = (topSpeed - endSpeed)/deceleration;
-		if (decelTime < idealPeriod)
-		{
-			proposedDeceleration = (topSpeed - endSpeed)/idealPeriod;
-			adjustDeceleration = true;
-		}
-		else if (decelTime < idealPeriod * 2)
+		if (decelTime < idealPeriod * maxPeriods)
 		{
-			proposedDeceleration = (topSpeed - endSpeed)/(idealPeriod * 2);
+			proposedDeceleration = (topSpeed - endSpeed)/(idealPeriod * ceilf(decelTime/idealPeriod));
 			adjustDeceleration = true;
 		}
 		if (adjustDeceleration)
@@ -1177,10 +1170,83 @@ inline void DDA::AdjustAcceleration() noexcept
 	}
 }
 
+// Return the constant acceleration that changes the speed by 'speedChange' in the same time as a jerk-limited (S-curve) profile with the specified maximum acceleration and jerk
+static float JerkLimitedAcceleration(float speedChange, float maxAcceleration, float jerkLimit) noexcept
+{
+	if (speedChange <= 0.0)
+	{
+		return maxAcceleration;
+	}
+	const float timeToReachMaxAcceleration = maxAcceleration/jerkLimit;
+	return (speedChange >= maxAcceleration * timeToReachMaxAcceleration)
+			? speedChange/(speedChange/maxAcceleration + timeToReachMaxAcceleration)		// the S-curve reaches the maximum acceleration
+			: sqrtf(speedChange * jerkLimit) * 0.5;										// the S-curve acceleration is triangular
+}
+
+// Reduce the acceleration and deceleration of the move so that each phase takes as long as it would if it followed an S-curve with the configured jerk limit.
+// The step generator only supports constant acceleration, so this doesn't remove the steps in acceleration at the start and end of each phase, but it reduces them
+// to the level that the S-curve would reach on average, which is what matters most for short moves and corners.
+// An acceleration or deceleration phase that continues from the previous or into the next move is left alone, because the speed change in this move is only part of it.
+// This is only called once, so inlined for speed
+inline void DDA::LimitJerk(float jerkLimit) noexcept
+{
+	const float maxAcceleration = ((prev->state != DDAState::frozen && prev->state != DDAState::executing) || !prev->IsAccelerationMove()) ? acceleration : 0.0;
+	const float maxDeceleration = (next->state != DDAState::provisional || !next->IsDecelerationMove()) ? deceleration : 0.0;
+
+	float newTopSpeed = topSpeed, newAcceleration, newDeceleration, newAccelDistance, newDecelDistance;
+	for (unsigned int iterations = 0; ; ++iterations)
+	{
+		newAcceleration = (maxAcceleration == 0.0) ? acceleration : JerkLimitedAcceleration(newTopSpeed - startSpeed, maxAcceleration, jerkLimit);
+		newDeceleration = (maxDeceleration == 0.0) ? deceleration : JerkLimitedAcceleration(newTopSpeed - endSpeed, maxDeceleration, jerkLimit);
+		newAccelDistance = (fsquare(newTopSpeed) - fsquare(startSpeed))/(2 * newAcceleration);
+		newDecelDistance = (fsquare(newTopSpeed) - fsquare(endSpeed))/(2 * newDeceleration);
+		if (newAccelDistance + newDecelDistance <= totalDistance)
+		{
+			break;
+		}
+
+		// The move is too short to reach the top speed at the reduced accelerations, so reduce the top speed.
+		// This reduces the speed changes and hence the jerk-limited accelerations too, so we iterate a few times. On the last iteration we keep the
+		// accelerations that we used to calculate the top speed, so that the move is consistent even though the jerk may be slightly above the limit.
+		newTopSpeed = sqrtf(  (2 * newAcceleration * newDeceleration * totalDistance + newDeceleration * fsquare(startSpeed) + newAcceleration * fsquare(endSpeed))
+							/ (newAcceleration + newDeceleration));
+		if (newTopSpeed <= startSpeed || newTopSpeed <= endSpeed)
+		{
+			return;			// this would change it into an accelerate-only or decelerate-only move, so give up
+		}
+		if (iterations == 2)
+		{
+			newAccelDistance = (fsquare(newTopSpeed) - fsquare(startSpeed))/(2 * newAcceleration);
+			newDecelDistance = totalDistance - newAccelDistance;
+			break;
+		}
+	}
+
+	if (newAcceleration < acceleration || newDeceleration < deceleration)
+	{
+		topSpeed = newTopSpeed;
+		acceleration = newAcceleration;
+		deceleration = newDeceleration;
+		beforePrepare.accelDistance = newAccelDistance;
+		beforePrepare.decelDistance = newDecelDistance;
+
+		const float totalTime =   (topSpeed - startSpeed)/acceleration
+								+ (topSpeed - endSpeed)/deceleration
+								+ (totalDistance - beforePrepare.accelDistance - beforePrepare.decelDistance)/topSpeed;
+		clocksNeeded = (uint32_t)(totalTime * StepTimer::StepClockRate);
+	}
+}
+
 // Prepare this DDA for execution.
 // This must not be called with interrupts disabled, because it calls Platform::EnableDrive.
 void DDA::Prepare(uint8_t simMode, float extrusionPending[]) noexcept
 {
+	const float jerkLimit = reprap.GetMove().GetJerkLimit();
+	if (flags.xyMoving && jerkLimit > 0.0 && topSpeed > startSpeed && topSpeed > endSpeed)
+	{
+		LimitJerk(jerkLimit);
+	}
+
 	if (   flags.xyMoving
 		&& reprap.GetMove().IsDRCenabled()
 		&& topSpeed > startSpeed && topSpeed > endSpeed
@@ -1847,8 +1913,9 @@ pre(state == frozen)
 uint32_t DDA::lastStepLowTime = 0;
 uint32_t DDA::lastDirChangeTime = 0;
 
-// Generate the step pulses of internal drivers used by this DDA. Return true if the move is complete and the next move should be started.
-void DDA::StepDrivers(Platform& p) noexcept
+// Generate the step pulses of internal drivers used by this DDA. Return the number of DriveMovements that we generated steps for.
+// The caller can tell whether the move is complete and the next move should be started by checking whether the state is now 'completed'.
+unsigned int DDA::StepDrivers(Platform& p) noexcept
 {
 	// 1. Check endstop switches and Z probe if asked. This is not speed critical because fast moves do not use endstops or the Z probe.
 	if (flags.checkEndstops)		// if any homing switches or the Z probe is enabled in this move
@@ -1856,7 +1923,7 @@ void DDA::StepDrivers(Platform& p) noexcept
 		CheckEndstops(p);			// call out to a separate function because this may help cache usage in the more common case where we don't call it
 		if (state == completed)		// we may have completed the move due to triggering an endstop switch or Z probe
 		{
-			return;
+			return 0;
 		}
 	}
 
@@ -1898,8 +1965,10 @@ void DDA::StepDrivers(Platform& p) noexcept
 	//    Note that the call to CalcNextStepTime may change the state of Direction pin.
 	DriveMovement *dmToInsert = activeDMs;							// head of the chain we need to re-insert
 	activeDMs = dm;													// remove the chain from the list
+	unsigned int numStepped = 0;
 	while (dmToInsert != dm)										// note that both of these may be nullptr
 	{
+		++numStepped;
 		const bool hasMoreSteps = (dmToInsert->isDelta)
 				? dmToInsert->CalcNextStepTimeDelta(*this, true)
 				: dmToInsert->CalcNextStepTimeCartesian(*this, true);
@@ -1924,6 +1993,7 @@ void DDA::StepDrivers(Platform& p) noexcept
 	{
 		state = completed;
 	}
+	return numStepped;
 }
 
 // Stop a drive and re-calculate the corresponding endpoint.
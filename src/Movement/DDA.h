@@ -46,7 +46,7 @@ public:
 #endif
 
 	void Start(Platform& p, uint32_t tim) noexcept __attribute__ ((hot));			// Start executing the DDA, i.e. move the move.
-	void StepDrivers(Platform& p) noexcept __attribute__ ((hot));					// Take one step of the DDA, called by timed interrupt.
+	unsigned int StepDrivers(Platform& p) noexcept __attribute__ ((hot));			// Take one step of the DDA, called by timed interrupt. Returns the number of local motors stepped.
 	bool ScheduleNextStepInterrupt(StepTimer& timer) const noexcept;				// Schedule the next interrupt, returning true if we can't because it is already due
 
 	void SetNext(DDA *n) noexcept { next = n; }
@@ -59,6 +59,7 @@ public:
 	bool IsPrintingMove() const noexcept { return flags.isPrintingMove; }			// Return true if this involves both XY movement and extrusion
 	bool UsingStandardFeedrate() const noexcept { return flags.usingStandardFeedrate; }
 	bool IsCheckingEndstops() const noexcept { return flags.checkEndstops; }
+	bool IsDeltaMovement() const noexcept { return flags.isDeltaMovement; }
 
 	DDAState GetState() const noexcept { return state; }
 	DDA* GetNext() const noexcept { return next; }
@@ -181,6 +182,7 @@ private:
 	void DebugPrintVector(const char *name, const float *vec, size_t len) const noexcept;
 	float NormaliseXYZ() noexcept;											// Make the direction vector unit-normal in XYZ
 	void AdjustAcceleration() noexcept;										// Adjust the acceleration and deceleration to reduce ringing
+	void LimitJerk(float jerkLimit) noexcept;								// Reduce the acceleration and deceleration to respect the jerk limit
 
 #if SUPPORT_CAN_EXPANSION
 	int32_t PrepareRemoteExtruder(size_t drive, float& extrusionPending, float speedChange) const noexcept;
@@ -8,6 +8,7 @@
 #include "DDARing.h"
 #include "RepRap.h"
 #include "Move.h"
+#include "OutputMemory.h"
 
 #if SUPPORT_CAN_EXPANSION
 # include "CAN/CanMotion.h"
@@ -15,8 +16,10 @@
 
 constexpr uint32_t UsualMinimumPreparedTime = StepTimer::StepClockRate/10;			// 100ms
 constexpr uint32_t AbsoluteMinimumPreparedTime = StepTimer::StepClockRate/20;		// 50ms
+constexpr unsigned int MaxPreparesPerSpin = 2;										// how many moves we prepare per call to Spin unless we are short of prepared moves
+constexpr uint32_t PrepareTimeFilterFactor = 16;									// the smoothing factor for the average prepare time
 
-DDARing::DDARing() noexcept : scheduledMoves(0), completedMoves(0), numHiccups(0)
+DDARing::DDARing() noexcept : scheduledMoves(0), completedMoves(0), numHiccups(0), numPreparedMoves(0), filteredPrepareClocks(0), completedDistance(0.0), completedClocks(0)
 {
 }
 
@@ -43,6 +46,29 @@ void DDARing::Init1(unsigned int numDdas) noexcept
 	timer.SetCallback(DDARing::TimerCallback, static_cast<void*>(this));
 }
 
+// Increase the number of DDAs in the ring. This is only possible when the ring is idle, because we insert the new DDAs just after the add pointer.
+// The DDA before the add pointer holds the position that the next move starts from, so we leave it alone.
+// DDAs that are waiting in the ring are not prepared and have no DriveMovements, so a longer ring lets us look further ahead without needing more DriveMovements.
+bool DDARing::SetNumDdas(unsigned int numDdas) noexcept
+{
+	RecycleDDAs();
+	if (!IsIdle() || checkPointer != addPointer)
+	{
+		return false;
+	}
+
+	while (numDdasInRing < numDdas)
+	{
+		DDA * const nextDda = addPointer->GetNext();
+		DDA * const newDda = new DDA(nextDda);
+		newDda->SetPrevious(addPointer);
+		nextDda->SetPrevious(newDda);
+		addPointer->SetNext(newDda);
+		++numDdasInRing;
+	}
+	return true;
+}
+
 // This must be called from Move::Init, not from the Move constructor, because it indirectly refers to the GCodes module which must therefore be initialised first
 void DDARing::Init2() noexcept
 {
@@ -106,6 +132,9 @@ void DDARing::RecycleDDAs() noexcept
 			reprap.GetPlatform().LogError(ErrorCode::BadMove);
 		}
 
+		completedDistance += checkPointer->GetTotalDistance();
+		completedClocks += checkPointer->GetClocksNeeded();
+
 		// Now release the DMs and check for underrun
 		if (checkPointer->Free())
 		{
@@ -262,6 +291,7 @@ void DDARing::Spin(uint8_t simulationMode, bool shouldStartMove) noexcept
 			cdda = cdda->GetNext();
 			if (cdda == addPointer)
 			{
+				numPreparedMoves = preparedCount;
 				return;												// all moves are already prepared
 			}
 		}
@@ -271,11 +301,14 @@ void DDARing::Spin(uint8_t simulationMode, bool shouldStartMove) noexcept
 }
 
 // Prepare some moves. moveTimeLeft is the total length remaining of moves that are already executing or prepared.
+// Unless we are short of prepared moves, we prepare only a few moves per call so that a burst of expensive prepares doesn't hold up reading new moves and lookahead.
 void DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, unsigned int alreadyPrepared, uint8_t simulationMode) noexcept
 {
 	// If the number of prepared moves will execute in less than the minimum time, prepare another move.
 	// Try to avoid preparing deceleration-only moves too early
+	unsigned int numPreparedThisCall = 0;
 	while (	  firstUnpreparedMove->GetState() == DDA::provisional
+		   && (numPreparedThisCall < MaxPreparesPerSpin || moveTimeLeft < (int32_t)AbsoluteMinimumPreparedTime)
 		   && DriveMovement::NumFree() >= (int)MaxAxesPlusExtruders	// check that we won't run out of DMs
 		   && moveTimeLeft < (int32_t)UsualMinimumPreparedTime		// prepare moves one eighth of a second ahead of when they will be needed
 		   && alreadyPrepared * 2 < numDdasInRing					// but don't prepare more than half the ring
@@ -285,11 +318,23 @@ void DDARing::PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, unsig
 #endif
 		  )
 	{
+		const uint32_t prepareStartTime = StepTimer::GetTimerTicks();
 		firstUnpreparedMove->Prepare(simulationMode, extrusionPending);
+		const uint32_t prepareClocks = StepTimer::GetTimerTicks() - prepareStartTime;
+		prepareTiming.Add(prepareClocks, 1);
+		filteredPrepareClocks = filteredPrepareClocks - filteredPrepareClocks/PrepareTimeFilterFactor + prepareClocks;
 		moveTimeLeft += firstUnpreparedMove->GetTimeLeft();
 		++alreadyPrepared;
+		++numPreparedThisCall;
 		firstUnpreparedMove = firstUnpreparedMove->GetNext();
 	}
+	numPreparedMoves = alreadyPrepared;
+}
+
+// Return the smoothed time taken to prepare a move in microseconds
+float DDARing::GetAveragePrepareMicroseconds() const noexcept
+{
+	return ((float)filteredPrepareClocks * (1.0e6/(float)StepTimer::StepClockRate))/(float)PrepareTimeFilterFactor;
 }
 
 // Return true if this DDA ring is idle
@@ -344,7 +389,9 @@ void DDARing::Interrupt(Platform& p) noexcept
 		for (;;)
 		{
 			// Generate a step for the current move
-			cdda->StepDrivers(p);						// check endstops if necessary and step the drivers
+			const uint16_t stepStartTime = StepTimer::GetTimerTicks16();
+			const unsigned int numStepped = cdda->StepDrivers(p);		// check endstops if necessary and step the drivers
+			((cdda->IsDeltaMovement()) ? deltaStepTiming : cartesianStepTiming).Add((uint16_t)(StepTimer::GetTimerTicks16() - stepStartTime), numStepped);
 			if (cdda->GetState() == DDA::completed)
 			{
 				OnMoveCompleted(cdda, p);
@@ -775,6 +822,51 @@ void DDARing::Diagnostics(MessageType mtype, const char *prefix) noexcept
 									prefix, scheduledMoves, completedMoves, stepErrors, numLookaheadErrors, numLookaheadUnderruns, numPrepareUnderruns,
 									(cdda == nullptr) ? -1 : (int)cdda->GetState());
 	stepErrors = numLookaheadUnderruns = numPrepareUnderruns = numLookaheadErrors = 0;
+
+	// Report the average speed of the moves completed since we last reported it, so that we can see whether the lookahead is long enough to reach full speed
+	if (completedClocks != 0)
+	{
+		reprap.GetPlatform().MessageF(mtype, "Ring length %u, average speed %.1fmm/sec\n",
+										numDdasInRing, (double)((completedDistance * (float)StepTimer::StepClockRate)/(float)completedClocks));
+	}
+	completedDistance = 0.0;
+	completedClocks = 0;
+
+	if (prepareTiming.GetNumSamples() != 0)
+	{
+		// Several drives whose steps fall due within the same MinInterruptInterval window are stepped together, so report how many we step per call
+		const uint32_t numStepCalls = cartesianStepTiming.GetNumSamples() + deltaStepTiming.GetNumSamples();
+		const uint32_t numSteps = cartesianStepTiming.GetNumItems() + deltaStepTiming.GetNumItems();
+		reprap.GetPlatform().MessageF(mtype, "Step time: %.0fns/step Cartesian, %.0fns/step delta, %.2f steps/call, prepare time: %.1fus avg, %" PRIu32 "us max\n",
+										(double)cartesianStepTiming.GetNanosecondsPerItem(), (double)deltaStepTiming.GetNanosecondsPerItem(),
+										(numStepCalls == 0) ? 0.0 : (double)numSteps/(double)numStepCalls,
+										(double)prepareTiming.GetMicrosecondsPerSample(),
+										(uint32_t)(((uint64_t)prepareTiming.GetMaxClocks() * 1000000u)/StepTimer::StepClockRate));
+	}
+	ResetTimingStats();
+}
+
+// Report the step generation and move preparation timing statistics as a JSON object and reset them
+void DDARing::AppendTimingAsJson(OutputBuffer *buf) noexcept
+{
+	buf->catf("{\"clockRate\":%" PRIu32 ",\"step\":{\"cartesian\":", StepTimer::StepClockRate);
+	cartesianStepTiming.AppendAsJson(buf);
+	buf->cat(",\"delta\":");
+	deltaStepTiming.AppendAsJson(buf);
+	buf->cat("},\"prepare\":");
+	prepareTiming.AppendAsJson(buf);
+	buf->cat('}');
+	ResetTimingStats();
+}
+
+// Reset the timing statistics. The step timing histograms are updated by the ISR, so lock it out while we clear them.
+void DDARing::ResetTimingStats() noexcept
+{
+	const uint32_t basepri = ChangeBasePriority(NvicPriorityStep);
+	cartesianStepTiming.Clear();
+	deltaStepTiming.Clear();
+	RestoreBasePriority(basepri);
+	prepareTiming.Clear();
 }
 
 #if SUPPORT_LASER
@@ -11,6 +11,7 @@
 #define SRC_MOVEMENT_DDARING_H_
 
 #include "DDA.h"
+#include "TimingHistogram.h"
 
 class DDARing
 {
@@ -20,6 +21,8 @@ public:
 	void Init1(unsigned int numDdas) noexcept;
 	void Init2() noexcept;
 	void Exit() noexcept;
+	bool SetNumDdas(unsigned int numDdas) noexcept;										// Increase the number of DDAs in the ring, returning true if successful
+	unsigned int GetNumDdas() const noexcept { return numDdasInRing; }
 
 	void RecycleDDAs() noexcept;
 	bool CanAddMove() const noexcept;
@@ -46,6 +49,9 @@ public:
 	uint32_t GetScheduledMoves() const noexcept { return scheduledMoves; }				// How many moves have been scheduled?
 	uint32_t GetCompletedMoves() const noexcept { return completedMoves; }				// How many moves have been completed?
 	void ResetMoveCounters() noexcept { scheduledMoves = completedMoves = 0; }
+	uint32_t GetQueueDepth() const noexcept { return scheduledMoves - completedMoves; }	// How many moves are in the ring waiting to be executed or executing?
+	unsigned int GetNumPreparedMoves() const noexcept { return numPreparedMoves; }		// How many moves were prepared or executing when we last looked?
+	float GetAveragePrepareMicroseconds() const noexcept;								// Get the smoothed time taken to prepare a move
 
 	float GetSimulationTime() const noexcept { return simulationTime; }
 	void ResetSimulationTime() noexcept { simulationTime = 0.0; }
@@ -82,10 +88,12 @@ public:
 
 	void RecordLookaheadError() noexcept { ++numLookaheadErrors; }						// Record a lookahead error
 	void Diagnostics(MessageType mtype, const char *prefix) noexcept;
+	void AppendTimingAsJson(OutputBuffer *buf) noexcept;								// Report the step generation and move preparation timing statistics and reset them
 
 private:
 	bool StartNextMove(Platform& p, uint32_t startTime) noexcept __attribute__ ((hot));	// Start the next move, returning true if laser or IObits need to be controlled
 	void PrepareMoves(DDA *firstUnpreparedMove, int32_t moveTimeLeft, unsigned int alreadyPrepared, uint8_t simulationMode) noexcept;
+	void ResetTimingStats() noexcept;
 
 	static void TimerCallback(CallbackParameter p) noexcept;
 
@@ -110,6 +118,15 @@ private:
 	unsigned int numLookaheadErrors;											// How many times our lookahead algorithm failed
 	unsigned int stepErrors;													// count of step errors, for diagnostics
 
+	TimingHistogram cartesianStepTiming;										// Time taken to generate steps for non-delta moves, modified in the ISR
+	TimingHistogram deltaStepTiming;											// Time taken to generate steps for segment-free delta moves, modified in the ISR
+	TimingHistogram prepareTiming;												// Time taken to prepare each move
+	unsigned int numPreparedMoves;												// How many moves were prepared or executing when we last prepared moves
+	uint32_t filteredPrepareClocks;												// The time taken to prepare a move, smoothed and multiplied by PrepareTimeFilterFactor
+
+	float completedDistance;													// Total length of the moves completed since we last reported the average speed
+	uint64_t completedClocks;													// Total duration of the moves completed since we last reported the average speed
+
 	float simulationTime;														// Print time since we started simulating
 	float extrusionPending[MaxExtruders];										// Extrusion not done due to rounding to nearest step
 	volatile int32_t extrusionAccumulators[MaxExtruders]; 						// Accumulated extruder motor steps
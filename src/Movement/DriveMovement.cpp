@@ -18,6 +18,11 @@
 DriveMovement *DriveMovement::freeList = nullptr;
 int DriveMovement::numFree = 0;
 int DriveMovement::minFree = 0;
+unsigned int DriveMovement::numCreated = 0;
+
+bool DriveMovement::useIncrementalRoots = true;
+uint32_t DriveMovement::numIncrementalRoots = 0;
+uint32_t DriveMovement::numFullRoots = 0;
 
 void DriveMovement::InitialAllocate(unsigned int num) noexcept
 {
@@ -25,6 +30,7 @@ void DriveMovement::InitialAllocate(unsigned int num) noexcept
 	{
 		freeList = new DriveMovement(freeList);
 		++numFree;
+		++numCreated;
 		--num;
 	}
 	ResetMinFree();
@@ -48,6 +54,51 @@ DriveMovement *DriveMovement::Allocate(size_t drive, DMState st) noexcept
 	return dm;
 }
 
+// Get and reset the square root statistics
+void DriveMovement::GetRootStats(uint32_t& numIncremental, uint32_t& numFull) noexcept
+{
+	const uint32_t oldPrio = ChangeBasePriority(NvicPriorityStep);
+	numIncremental = numIncrementalRoots;
+	numFull = numFullRoots;
+	numIncrementalRoots = numFullRoots = 0;
+	RestoreBasePriority(oldPrio);
+}
+
+// Return the integer square root of 'num', rounded down. The result is always identical to isqrt64(num).
+// During the acceleration and deceleration phases the step times follow a square root law, so the root for this step is very close to the root for the previous one.
+// If we are given such an estimate, we refine it with a single Newton-Raphson iteration using 32-bit division and a couple of integer corrections,
+// which is much quicker than a full 64-bit square root. If the estimate is poor, or if it is zero, we fall back to isqrt64.
+uint32_t DriveMovement::CalcRoot(uint64_t num, uint32_t estimate) noexcept
+{
+	if (useIncrementalRoots && estimate != 0 && estimate < 0x40000000)
+	{
+		const int64_t diff = (int64_t)(num - isquare64(estimate));
+		if (diff >= -(int64_t)0x7FFFFFFF && diff <= (int64_t)0x7FFFFFFF)
+		{
+			uint32_t root = (uint32_t)((int32_t)estimate + (int32_t)diff/(int32_t)(2 * estimate));
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				const uint64_t square = isquare64(root);
+				if (square > num)
+				{
+					--root;
+				}
+				else if (num - square > 2 * (uint64_t)root)		// if (root + 1)^2 <= num
+				{
+					++root;
+				}
+				else
+				{
+					++numIncrementalRoots;
+					return root;
+				}
+			}
+		}
+	}
+	++numFullRoots;
+	return isqrt64(num);
+}
+
 // Constructors
 DriveMovement::DriveMovement(DriveMovement *next) noexcept : nextDM(next)
 {
@@ -177,6 +228,10 @@ bool DriveMovement::PrepareDeltaAxis(const DDA& dda, const PrepParams& params) n
 		twoDistanceToStopTimesCsquaredDivD = isquare64(params.topSpeedTimesCdivD) + roundU64((params.decelStartDistance * (StepTimer::StepClockRateSquared * 2))/dda.deceleration);
 	}
 
+#if DELTA_INCREMENTAL_ROOTS
+	mp.delta.lastT2 = 0;							// we have no estimate for the first square root
+#endif
+
 	// Prepare for the first step
 	nextStep = 0;
 	nextStepTime = 0;
@@ -385,7 +440,8 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	{
 		// acceleration phase
 		const uint32_t adjustedStartSpeedTimesCdivA = dda.afterPrepare.startSpeedTimesCdivA + mp.cart.compensationClocks;
-		nextCalcStepTime = isqrt64(isquare64(adjustedStartSpeedTimesCdivA) + (mp.cart.twoCsquaredTimesMmPerStepDivA * nextCalcStep)) - adjustedStartSpeedTimesCdivA;
+		nextCalcStepTime = CalcRoot(isquare64(adjustedStartSpeedTimesCdivA) + (mp.cart.twoCsquaredTimesMmPerStepDivA * nextCalcStep), nextStepTime + adjustedStartSpeedTimesCdivA)
+							- adjustedStartSpeedTimesCdivA;
 	}
 	else if (nextCalcStep < mp.cart.decelStartStep)
 	{
@@ -402,7 +458,9 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 		const uint32_t adjustedTopSpeedTimesCdivDPlusDecelStartClocks = dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks - mp.cart.compensationClocks;
 		// Allow for possible rounding error when the end speed is zero or very small
 		nextCalcStepTime = (temp < twoDistanceToStopTimesCsquaredDivD)
-						? adjustedTopSpeedTimesCdivDPlusDecelStartClocks - isqrt64(twoDistanceToStopTimesCsquaredDivD - temp)
+						? adjustedTopSpeedTimesCdivDPlusDecelStartClocks
+							- CalcRoot(twoDistanceToStopTimesCsquaredDivD - temp,
+										(nextStepTime < adjustedTopSpeedTimesCdivDPlusDecelStartClocks) ? adjustedTopSpeedTimesCdivDPlusDecelStartClocks - nextStepTime : 0)
 						: adjustedTopSpeedTimesCdivDPlusDecelStartClocks;
 	}
 	else
@@ -418,7 +476,8 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 		}
 		const uint32_t adjustedTopSpeedTimesCdivDPlusDecelStartClocks = dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks - mp.cart.compensationClocks;
 		nextCalcStepTime = adjustedTopSpeedTimesCdivDPlusDecelStartClocks
-							+ isqrt64((int64_t)(mp.cart.twoCsquaredTimesMmPerStepDivD * nextCalcStep) - mp.cart.fourMaxStepDistanceMinusTwoDistanceToStopTimesCsquaredDivD);
+							+ CalcRoot((int64_t)(mp.cart.twoCsquaredTimesMmPerStepDivD * nextCalcStep) - mp.cart.fourMaxStepDistanceMinusTwoDistanceToStopTimesCsquaredDivD,
+										(nextStepTime > adjustedTopSpeedTimesCdivDPlusDecelStartClocks) ? nextStepTime - adjustedTopSpeedTimesCdivDPlusDecelStartClocks : 0);
 	}
 
 	// When crossing between movement phases with high microstepping, due to rounding errors the next step may appear to be due before the last one
@@ -510,7 +569,13 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	const int32_t t1 = mp.delta.minusAaPlusBbTimesKs + hmz0scK;
 	// Due to rounding error we can end up trying to take the square root of a negative number if we do not take precautions here
 	const int64_t t2a = mp.delta.dSquaredMinusAsquaredMinusBsquaredTimesKsquaredSsquared - (int64_t)isquare64(mp.delta.hmz0sK) + (int64_t)isquare64(t1);
+#if DELTA_INCREMENTAL_ROOTS
+	// t2 changes only a little from one step to the next, so the previous value is a good starting point for the square root
+	const int32_t t2 = (t2a > 0) ? CalcRoot(t2a, mp.delta.lastT2) : 0;
+	mp.delta.lastT2 = t2;
+#else
 	const int32_t t2 = (t2a > 0) ? isqrt64(t2a) : 0;
+#endif
 	const int32_t dsK = (direction) ? t1 - t2 : t1 + t2;
 
 	// Now feed dsK into a modified version of the step algorithm for Cartesian motion without elasticity compensation
@@ -525,7 +590,12 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	if ((uint32_t)dsK < mp.delta.accelStopDsK)
 	{
 		// Acceleration phase
+#if DELTA_INCREMENTAL_ROOTS
+		nextCalcStepTime = CalcRoot(isquare64(dda.afterPrepare.startSpeedTimesCdivA) + (mp.delta.twoCsquaredTimesMmPerStepDivA * (uint32_t)dsK)/K2, nextStepTime + dda.afterPrepare.startSpeedTimesCdivA)
+							- dda.afterPrepare.startSpeedTimesCdivA;
+#else
 		nextCalcStepTime = isqrt64(isquare64(dda.afterPrepare.startSpeedTimesCdivA) + (mp.delta.twoCsquaredTimesMmPerStepDivA * (uint32_t)dsK)/K2) - dda.afterPrepare.startSpeedTimesCdivA;
+#endif
 	}
 	else if ((uint32_t)dsK < mp.delta.decelStartDsK)
 	{
@@ -538,9 +608,17 @@ pre(nextStep < totalSteps; stepsTillRecalc == 0)
 	{
 		const uint64_t temp = (mp.delta.twoCsquaredTimesMmPerStepDivD * (uint32_t)dsK)/K2;
 		// Because of possible rounding error when the end speed is zero or very small, we need to check that the square root will work OK
+#if DELTA_INCREMENTAL_ROOTS
+		nextCalcStepTime = (temp < twoDistanceToStopTimesCsquaredDivD)
+						? dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks
+							- CalcRoot(twoDistanceToStopTimesCsquaredDivD - temp,
+										(nextStepTime < dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks) ? dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks - nextStepTime : 0)
+						: dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks;
+#else
 		nextCalcStepTime = (temp < twoDistanceToStopTimesCsquaredDivD)
 						? dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks - isqrt64(twoDistanceToStopTimesCsquaredDivD - temp)
 						: dda.afterPrepare.topSpeedTimesCdivDPlusDecelStartClocks;
+#endif
 	}
 
 	// When crossing between movement phases with high microstepping, due to rounding errors the next step may appear to be due before the last one.
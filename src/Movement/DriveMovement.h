@@ -15,6 +15,10 @@ class LinearDeltaKinematics;
 #define EVEN_STEPS			(1)			// 1 to generate steps at even intervals when doing double/quad/octal stepping
 #define ROUND_TO_NEAREST	(0)			// 1 for round to nearest (as used in 1.20beta10), 0 for round down (as used prior to 1.20beta10)
 
+#ifndef DELTA_INCREMENTAL_ROOTS
+# define DELTA_INCREMENTAL_ROOTS	(1)	// 1 to seed the square roots in the delta step calculation from the previous step, 0 to calculate them in full every time
+#endif
+
 // Rounding functions, to improve code clarity. Also allows a quick switch between round-to-nearest and round down in the movement code.
 inline uint32_t roundU32(float f) noexcept
 {
@@ -154,18 +158,30 @@ public:
 
 	static void InitialAllocate(unsigned int num) noexcept;
 	static int NumFree() noexcept { return numFree; }
+	static unsigned int NumCreated() noexcept { return numCreated; }
 	static int MinFree() noexcept { return minFree; }
 	static void ResetMinFree() noexcept { minFree = numFree; }
 	static DriveMovement *Allocate(size_t drive, DMState st) noexcept;
 	static void Release(DriveMovement *item) noexcept;
 
+	static bool UsingIncrementalRoots() noexcept { return useIncrementalRoots; }
+	static void SetIncrementalRoots(bool b) noexcept { useIncrementalRoots = b; }
+	static void GetRootStats(uint32_t& numIncremental, uint32_t& numFull) noexcept;	// get and reset the square root statistics
+
 private:
 	bool CalcNextStepTimeCartesianFull(const DDA &dda, bool live) noexcept __attribute__ ((hot));
 	bool CalcNextStepTimeDeltaFull(const DDA &dda, bool live) noexcept __attribute__ ((hot));
 
+	static uint32_t CalcRoot(uint64_t num, uint32_t estimate) noexcept __attribute__ ((hot));
+
 	static DriveMovement *freeList;
 	static int numFree;
 	static int minFree;
+	static unsigned int numCreated;
+
+	static bool useIncrementalRoots;					// true to seed the acceleration and deceleration square roots from the previous step time
+	static uint32_t numIncrementalRoots;				// how many square roots we calculated incrementally
+	static uint32_t numFullRoots;						// how many square roots needed a full calculation
 
 	// Parameters common to Cartesian, delta and extruder moves
 
@@ -221,6 +237,9 @@ private:
 			uint32_t accelStopDsK;
 			uint32_t decelStartDsK;
 			uint32_t mmPerStepTimesCKdivtopSpeed;
+#if DELTA_INCREMENTAL_ROOTS
+			uint32_t lastT2;							// the square root we calculated for the previous step, used as the estimate for the next one
+#endif
 		} delta;
 	} mp;
 
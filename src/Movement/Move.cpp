@@ -39,6 +39,7 @@
 #include "GCodes/GCodeBuffer/GCodeBuffer.h"
 #include "Tools/Tool.h"
 #include "Endstops/ZProbe.h"
+#include "Tasks.h"
 #include <TaskPriorities.h>
 
 #if SUPPORT_IOBITS
@@ -84,15 +85,19 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 	{ "daa",					OBJECT_MODEL_FUNC(self, 1),																ObjectModelEntryFlags::none },
 	{ "extruders",				OBJECT_MODEL_FUNC_NOSELF(&extrudersArrayDescriptor),									ObjectModelEntryFlags::live },
 	{ "idle",					OBJECT_MODEL_FUNC(self, 2),																ObjectModelEntryFlags::none },
+	{ "jerkLimit",				OBJECT_MODEL_FUNC(self->jerkLimit, 1),													ObjectModelEntryFlags::none },
 	{ "kinematics",				OBJECT_MODEL_FUNC(self->kinematics),													ObjectModelEntryFlags::none },
 	{ "printingAcceleration",	OBJECT_MODEL_FUNC(self->maxPrintingAcceleration, 1),									ObjectModelEntryFlags::none },
+	{ "queue",					OBJECT_MODEL_FUNC(self, 10),															ObjectModelEntryFlags::live },
 	{ "speedFactor",			OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().GetSpeedFactor(), 2),						ObjectModelEntryFlags::none },
 	{ "travelAcceleration",		OBJECT_MODEL_FUNC(self->maxTravelAcceleration, 1),										ObjectModelEntryFlags::none },
 	{ "virtualEPos",			OBJECT_MODEL_FUNC_NOSELF(reprap.GetGCodes().GetVirtualExtruderPosition(), 5),			ObjectModelEntryFlags::live },
 	{ "workspaceNumber",		OBJECT_MODEL_FUNC_NOSELF((int32_t)reprap.GetGCodes().GetWorkplaceCoordinateSystemNumber()),	ObjectModelEntryFlags::none },
 
 	// 1. Move.Daa members
+	{ "damping",				OBJECT_MODEL_FUNC(self->drcDamping, 2),													ObjectModelEntryFlags::none },
 	{ "enabled", 				OBJECT_MODEL_FUNC(self->drcEnabled), 													ObjectModelEntryFlags::none },
+	{ "maxPeriods",				OBJECT_MODEL_FUNC((int32_t)self->drcMaxPeriods),										ObjectModelEntryFlags::none },
 	{ "minimumAcceleration",	OBJECT_MODEL_FUNC(self->drcMinimumAcceleration, 1),										ObjectModelEntryFlags::none },
 	{ "period",					OBJECT_MODEL_FUNC(self->drcPeriod, 1), 													ObjectModelEntryFlags::none },
 
@@ -141,9 +146,15 @@ constexpr ObjectModelTableEntry Move::objectModelTable[] =
 	{ "tanXY",					OBJECT_MODEL_FUNC(self->tanXY, 4),														ObjectModelEntryFlags::none },
 	{ "tanXZ",					OBJECT_MODEL_FUNC(self->tanXZ, 4),														ObjectModelEntryFlags::none },
 	{ "tanYZ",					OBJECT_MODEL_FUNC(self->tanYZ, 4),														ObjectModelEntryFlags::none },
+
+	// 10. move.queue members
+	{ "depth",					OBJECT_MODEL_FUNC((int32_t)self->mainDDARing.GetQueueDepth()),							ObjectModelEntryFlags::live },
+	{ "length",					OBJECT_MODEL_FUNC((int32_t)self->mainDDARing.GetNumDdas()),								ObjectModelEntryFlags::none },
+	{ "prepareTime",			OBJECT_MODEL_FUNC(self->mainDDARing.GetAveragePrepareMicroseconds(), 1),				ObjectModelEntryFlags::live },
+	{ "prepared",				OBJECT_MODEL_FUNC((int32_t)self->mainDDARing.GetNumPreparedMoves()),					ObjectModelEntryFlags::live },
 };
 
-constexpr uint8_t Move::objectModelTableDescriptor[] = { 10, 13, 3, 2, 4 + SUPPORT_LASER, 3, 2, 2, 5 + (HAS_MASS_STORAGE || HAS_LINUX_INTERFACE), 2, 3 };
+constexpr uint8_t Move::objectModelTableDescriptor[] = { 11, 15, 5, 2, 4 + SUPPORT_LASER, 3, 2, 2, 5 + (HAS_MASS_STORAGE || HAS_LINUX_INTERFACE), 2, 3, 4 };
 
 DEFINE_GET_OBJECT_MODEL_TABLE(Move)
 
@@ -156,9 +167,11 @@ Move::Move() noexcept
 #endif
 	  active(false),
 	  drcEnabled(false),											// disable dynamic ringing cancellation
-	  maxPrintingAcceleration(10000.0), maxTravelAcceleration(10000.0),
+	  maxPrintingAcceleration(10000.0), maxTravelAcceleration(10000.0), jerkLimit(0.0),
 	  drcPeriod(0.025),												// 40Hz
+	  drcDamping(0.0), drcDampedPeriod(0.025),
 	  drcMinimumAcceleration(10.0),
+	  drcMaxPeriods(2),
 	  jerkPolicy(0),
 	  numCalibratedFactors(0)
 {
@@ -422,6 +435,11 @@ void Move::Diagnostics(MessageType mtype) noexcept
 	longestGcodeWaitInterval = 0;
 	DriveMovement::ResetMinFree();
 
+	uint32_t numIncrementalRoots, numFullRoots;
+	DriveMovement::GetRootStats(numIncrementalRoots, numFullRoots);
+	p.MessageF(mtype, "Step calc: %s, square roots %" PRIu32 " incremental %" PRIu32 " full\n",
+						(DriveMovement::UsingIncrementalRoots()) ? "incremental" : "full", numIncrementalRoots, numFullRoots);
+
 #if defined(__ALLIGATOR__)
 	// Motor Fault Diagnostic
 	reprap.GetPlatform().MessageF(mtype, "Motor Fault status: %s\n", digitalRead(MotorFaultDetectPin) ? "none" : "FAULT detected!" );
@@ -987,6 +1005,11 @@ GCodeResult Move::ConfigureAccelerations(GCodeBuffer&gb, const StringRef& reply)
 		seen = true;
 		maxTravelAcceleration = gb.GetFValue();
 	}
+	if (gb.Seen('J'))
+	{
+		seen = true;
+		jerkLimit = max<float>(gb.GetFValue(), 0.0);
+	}
 	if (seen)
 	{
 		reprap.MoveUpdated();
@@ -994,6 +1017,10 @@ GCodeResult Move::ConfigureAccelerations(GCodeBuffer&gb, const StringRef& reply)
 	else
 	{
 		reply.printf("Maximum printing acceleration %.1f, maximum travel acceleration %.1f", (double)maxPrintingAcceleration, (double)maxTravelAcceleration);
+		if (jerkLimit > 0.0)
+		{
+			reply.catf(", jerk limit %.0f", (double)jerkLimit);
+		}
 	}
 	return GCodeResult::ok;
 }
@@ -1016,21 +1043,34 @@ GCodeResult Move::ConfigureDynamicAcceleration(GCodeBuffer& gb, const StringRef&
 			drcEnabled = false;
 		}
 	}
+	if (gb.Seen('S'))
+	{
+		seen = true;
+		drcDamping = constrain<float>(gb.GetFValue(), 0.0, 0.99);
+	}
 	if (gb.Seen('L'))
 	{
 		seen = true;
 		drcMinimumAcceleration = max<float>(gb.GetFValue(), 1.0);		// very low accelerations cause problems with the maths
 	}
+	if (gb.Seen('N'))
+	{
+		seen = true;
+		drcMaxPeriods = constrain<unsigned int>(gb.GetUIValue(), 1, 8);
+	}
 
 	if (seen)
 	{
+		// Damped ringing has a longer period than the undamped natural frequency
+		drcDampedPeriod = drcPeriod/sqrtf(1.0 - fsquare(drcDamping));
 		reprap.MoveUpdated();
 	}
 	else
 	{
 		if (reprap.GetMove().IsDRCenabled())
 		{
-			reply.printf("Dynamic ringing cancellation at %.1fHz, min. acceleration %.1f", (double)(1.0/drcPeriod), (double)drcMinimumAcceleration);
+			reply.printf("Dynamic ringing cancellation at %.1fHz, damping ratio %.2f, min. acceleration %.1f, max. %u periods",
+							(double)(1.0/drcPeriod), (double)drcDamping, (double)drcMinimumAcceleration, drcMaxPeriods);
 		}
 		else
 		{
@@ -1040,6 +1080,70 @@ GCodeResult Move::ConfigureDynamicAcceleration(GCodeBuffer& gb, const StringRef&
 	return GCodeResult::ok;
 }
 
+// Process M595
+// P is the number of moves in the main movement queue and S is the total number of DriveMovement objects. Both can only be increased.
+// A longer queue lets the lookahead see further ahead when the moves are very short. Moves only need DriveMovement objects once they have been prepared,
+// so the queue can be made longer without increasing S, at the cost of a DDA for each extra move.
+GCodeResult Move::ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& reply) noexcept
+{
+	const unsigned int oldNumDdas = mainDDARing.GetNumDdas();
+	const unsigned int oldNumDms = DriveMovement::NumCreated();
+	unsigned int newNumDdas = oldNumDdas, newNumDms = oldNumDms;
+	bool seen = false;
+	if (gb.Seen('P'))
+	{
+		seen = true;
+		newNumDdas = max<unsigned int>(gb.GetUIValue(), oldNumDdas);
+	}
+	if (gb.Seen('S'))
+	{
+		seen = true;
+		newNumDms = max<unsigned int>(gb.GetUIValue(), oldNumDms);
+	}
+
+	if (!seen)
+	{
+		reply.printf("Movement queue length %u, %u DriveMovements", oldNumDdas, oldNumDms);
+		return GCodeResult::ok;
+	}
+
+	if (newNumDdas > MaxDdaRingLength || newNumDms > MaxNumDms)
+	{
+		reply.printf("Movement queue length is limited to %u and DriveMovements to %u", MaxDdaRingLength, MaxNumDms);
+		return GCodeResult::error;
+	}
+
+	const uint64_t memoryNeeded = (uint64_t)(newNumDdas - oldNumDdas) * sizeof(DDA) + (uint64_t)(newNumDms - oldNumDms) * sizeof(DriveMovement);
+	if (memoryNeeded + MinimumFreeRamAfterQueueExtension > Tasks::GetNeverUsedRam())
+	{
+		reply.printf("Not enough memory, %" PRIu32 " bytes needed", (uint32_t)memoryNeeded);
+		return GCodeResult::error;
+	}
+	if (!mainDDARing.SetNumDdas(newNumDdas))
+	{
+		reply.copy("Movement queue length can only be changed when the machine is not moving");
+		return GCodeResult::error;
+	}
+	DriveMovement::InitialAllocate(newNumDms - oldNumDms);
+	return GCodeResult::ok;
+}
+
+// Process M596
+// Select whether the acceleration and deceleration step times are calculated incrementally from the previous step time (S1) or from scratch (S0).
+// The results are identical, so this only exists so that the step timing reported by M122 can be compared between the two methods.
+GCodeResult Move::ConfigureStepGeneration(GCodeBuffer& gb, const StringRef& reply) noexcept
+{
+	if (gb.Seen('S'))
+	{
+		DriveMovement::SetIncrementalRoots(gb.GetIValue() > 0);
+	}
+	else
+	{
+		reply.printf("Step times are calculated %s", (DriveMovement::UsingIncrementalRoots()) ? "incrementally" : "in full");
+	}
+	return GCodeResult::ok;
+}
+
 // Return the current live XYZ and extruder coordinates
 // Interrupts are assumed enabled on entry
 float Move::LiveCoordinate(unsigned int axisOrExtruder, const Tool *tool) noexcept
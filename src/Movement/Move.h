@@ -47,6 +47,10 @@ const unsigned int NumDms = 20 * 5;												// suitable for e.g. a delta + 2-
 
 #endif
 
+constexpr uint32_t MinimumFreeRamAfterQueueExtension = 4096;					// how much never-used RAM we insist on leaving when M595 lengthens the movement queue
+constexpr unsigned int MaxDdaRingLength = DdaRingLength * 8;					// the longest movement queue that M595 will set up
+constexpr unsigned int MaxNumDms = NumDms * 8;									// the most DriveMovements that M595 will allocate
+
 constexpr uint32_t MovementStartDelayClocks = StepTimer::StepClockRate/100;		// 10ms delay between preparing the first move and starting it
 
 // This is the master movement class.  It controls all movement in the machine.
@@ -94,15 +98,21 @@ public:
 
 	GCodeResult ConfigureAccelerations(GCodeBuffer&gb, const StringRef& reply) noexcept;		// process M204
 	GCodeResult ConfigureDynamicAcceleration(GCodeBuffer& gb, const StringRef& reply) noexcept;	// process M593
+	GCodeResult ConfigureMovementQueue(GCodeBuffer& gb, const StringRef& reply) noexcept;		// process M595
+	GCodeResult ConfigureStepGeneration(GCodeBuffer& gb, const StringRef& reply) noexcept;		// process M596
 
 	float GetMaxPrintingAcceleration() const noexcept { return maxPrintingAcceleration; }
 	float GetMaxTravelAcceleration() const noexcept { return maxTravelAcceleration; }
+	float GetJerkLimit() const noexcept { return jerkLimit; }
 	float GetDRCfreq() const noexcept { return 1.0/drcPeriod; }
 	float GetDRCperiod() const noexcept { return drcPeriod; }
+	float GetDRCdampedPeriod() const noexcept { return drcDampedPeriod; }
+	unsigned int GetDRCmaxPeriods() const noexcept { return drcMaxPeriods; }
 	float GetDRCminimumAcceleration() const noexcept { return drcMinimumAcceleration; }
 	float IsDRCenabled() const noexcept { return drcEnabled; }
 
 	void Diagnostics(MessageType mtype) noexcept;							// Report useful stuff
+	void AppendTimingAsJson(OutputBuffer *buf) noexcept { mainDDARing.AppendTimingAsJson(buf); }	// Report step and move preparation timing statistics
 
 	// Kinematics and related functions
 	Kinematics& GetKinematics() const noexcept { return *kinematics; }
@@ -234,8 +244,12 @@ private:
 
 	float maxPrintingAcceleration;
 	float maxTravelAcceleration;
+	float jerkLimit;									// the maximum rate of change of acceleration in mm/sec^3, or zero if there is no limit
 	float drcPeriod;									// the period of ringing that we don't want to excite
+	float drcDamping;									// the damping ratio of the ringing
+	float drcDampedPeriod;								// the period of the ringing after allowing for damping
 	float drcMinimumAcceleration;						// the minimum value that we reduce acceleration to
+	unsigned int drcMaxPeriods;							// the maximum number of ringing periods that we stretch acceleration and deceleration to
 
 	unsigned int jerkPolicy;							// When we allow jerk
 	unsigned int idleCount;								// The number of times Spin was called and had no new moves to process
@@ -0,0 +1,45 @@
+/*
+ * TimingHistogram.cpp
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include "TimingHistogram.h"
+#include "StepTimer.h"
+#include "OutputMemory.h"
+
+void TimingHistogram::Clear() noexcept
+{
+	totalClocks = 0;
+	numSamples = numItems = maxClocks = 0;
+	for (uint32_t& b : buckets)
+	{
+		b = 0;
+	}
+}
+
+// Return the average time per item in nanoseconds, or 0 if there have been no items
+float TimingHistogram::GetNanosecondsPerItem() const noexcept
+{
+	return (numItems == 0) ? 0.0 : ((float)totalClocks * (1.0e9/(float)StepTimer::StepClockRate))/(float)numItems;
+}
+
+// Return the average time per sample in microseconds, or 0 if there have been no samples
+float TimingHistogram::GetMicrosecondsPerSample() const noexcept
+{
+	return (numSamples == 0) ? 0.0 : ((float)totalClocks * (1.0e6/(float)StepTimer::StepClockRate))/(float)numSamples;
+}
+
+// Append the statistics to an output buffer as a JSON object
+void TimingHistogram::AppendAsJson(OutputBuffer *buf) const noexcept
+{
+	buf->catf("{\"samples\":%" PRIu32 ",\"items\":%" PRIu32 ",\"clocks\":%" PRIu64 ",\"maxClocks\":%" PRIu32 ",\"nsPerItem\":%.1f,\"histogram\":[",
+				numSamples, numItems, totalClocks, maxClocks, (double)GetNanosecondsPerItem());
+	for (size_t i = 0; i < NumBuckets; ++i)
+	{
+		buf->catf((i == 0) ? "%" PRIu32 : ",%" PRIu32, buckets[i]);
+	}
+	buf->cat("]}");
+}
+
+// End
@@ -0,0 +1,56 @@
+/*
+ * TimingHistogram.h
+ *
+ *  Created on: 17 Oct 2026
+ *
+ *  This class accumulates the time taken by a repeated operation (e.g. generating steps or preparing a move) so that we can tell
+ *  whether a firmware change makes movement code faster or slower without needing a logic analyser.
+ *  Times are measured in step clocks. The histogram buckets are logarithmic: bucket 0 counts samples that took 0 clocks, bucket N counts samples that took 2^(N-1) to 2^N - 1 clocks.
+ */
+
+#ifndef SRC_MOVEMENT_TIMINGHISTOGRAM_H_
+#define SRC_MOVEMENT_TIMINGHISTOGRAM_H_
+
+#include "RepRapFirmware.h"
+
+class TimingHistogram
+{
+public:
+	static constexpr size_t NumBuckets = 12;				// the last bucket counts samples of 1024 clocks or more
+
+	TimingHistogram() noexcept { Clear(); }
+
+	void Clear() noexcept;
+	void Add(uint32_t clocks, uint32_t numItems) noexcept;	// record a sample that took 'clocks' step clocks to process 'numItems' items (e.g. steps)
+
+	uint32_t GetNumSamples() const noexcept { return numSamples; }
+	uint32_t GetNumItems() const noexcept { return numItems; }
+	uint32_t GetMaxClocks() const noexcept { return maxClocks; }
+	float GetNanosecondsPerItem() const noexcept;			// return the average time per item in nanoseconds, or 0 if there have been no items
+	float GetMicrosecondsPerSample() const noexcept;		// return the average time per sample in microseconds, or 0 if there have been no samples
+
+	void AppendAsJson(OutputBuffer *buf) const noexcept;	// append the statistics to an output buffer as a JSON object
+
+private:
+	uint64_t totalClocks;
+	uint32_t numSamples;
+	uint32_t numItems;
+	uint32_t maxClocks;
+	uint32_t buckets[NumBuckets];
+};
+
+// Record a sample. This is called from the step ISR, so it must be fast.
+inline void TimingHistogram::Add(uint32_t clocks, uint32_t items) noexcept
+{
+	++numSamples;
+	numItems += items;
+	totalClocks += clocks;
+	if (clocks > maxClocks)
+	{
+		maxClocks = clocks;
+	}
+	const size_t bucket = (clocks == 0) ? 0 : (size_t)(32 - __builtin_clz(clocks));
+	++buckets[min<size_t>(bucket, NumBuckets - 1)];
+}
+
+#endif /* SRC_MOVEMENT_TIMINGHISTOGRAM_H_ */
@@ -33,6 +33,9 @@ const char* const ErrorPagePart2 =
 	"</body>\n";
 
 HttpResponder::HttpResponder(NetworkResponder *n) noexcept : UploadingNetworkResponder(n)
+#if SUPPORT_OBJECT_MODEL
+	, modelCursor(0), sendingModel(false), modelEntrySent(false), binaryResponse(false)
+#endif
 {
 }
 
@@ -52,6 +55,9 @@ bool HttpResponder::Accept(Socket *s, NetworkProtocol protocol) noexcept
 		numQualKeys = 0;
 		numHeaderKeys = 0;
 		commandWords[0] = clientMessage;
+#if SUPPORT_OBJECT_MODEL
+		sendingModel = false;
+#endif
 
 		if (reprap.Debug(moduleWebserver))
 		{
@@ -450,6 +456,9 @@ bool HttpResponder::CharFromClient(char c) noexcept
 bool HttpResponder::GetJsonResponse(const char* request, OutputBuffer *&response, bool& keepOpen) noexcept
 {
 	keepOpen = false;	// assume we don't want to persist the connection
+#if SUPPORT_OBJECT_MODEL
+	binaryResponse = false;
+#endif
 	const char *parameter;
 	if (StringEqualsIgnoreCase(request, "connect") && (parameter = GetKeyValue("password")) != nullptr)
 	{
@@ -621,7 +630,24 @@ bool HttpResponder::GetJsonResponse(const char* request, OutputBuffer *&response
 		OutputBuffer::ReleaseAll(response);
 		const char *const filterVal = GetKeyValue("key");
 		const char *const flagsVal = GetKeyValue("flags");
+		binaryResponse = (flagsVal != nullptr && ObjectModel::IsBinaryReport(flagsVal));
 		response = reprap.GetModelResponse(filterVal, flagsVal);
+		if (   response != nullptr && response->HadOverflow()
+			&& (filterVal == nullptr || filterVal[0] == 0) && (flagsVal == nullptr || strlen(flagsVal) < StringLength20)
+		   )
+		{
+			// The whole object model didn't fit in the free output buffers, so send the header now and generate the rest while we are sending it.
+			// We only do this when we have to, because the response has no Content-Length, so the client can't keep the connection open.
+			OutputBuffer::ReleaseAll(response);
+			if (OutputBuffer::Allocate(response))
+			{
+				modelFlags.copy((flagsVal == nullptr) ? "" : flagsVal);
+				reprap.ReportModelResponseHeader(response, "", modelFlags.c_str());
+				modelCursor = 0;
+				modelEntrySent = false;
+				sendingModel = true;
+			}
+		}
 	}
 #endif
 	else if (StringEqualsIgnoreCase(request, "config"))
@@ -1004,6 +1030,9 @@ void HttpResponder::SendJsonResponse(const char* command) noexcept
 		// We ran out of buffers at some point.
 		// DC 2020-05-05: we no longer retry or discard responses if there are no buffers available, instead we return a 503 error immediately
 		ReportOutputBufferExhaustion(__FILE__, __LINE__);
+#if SUPPORT_OBJECT_MODEL
+		sendingModel = false;
+#endif
 
 		// We know that we have an output buffer, but it may be too short to send a long reply, so send a short one
 		outBuf->copy(serviceUnavailableResponse);
@@ -1037,10 +1066,22 @@ void HttpResponder::SendJsonResponse(const char* command) noexcept
 					"Pragma: no-cache\r\n"
 					"Expires: 0\r\n"
 					"Access-Control-Allow-Origin: *\r\n"
-					"Content-Type: application/json\r\n"
 				);
-	const unsigned int replyLength = (jsonResponse != nullptr) ? jsonResponse->Length() : 0;
-	outBuf->catf("Content-Length: %u\r\n", replyLength);
+#if SUPPORT_OBJECT_MODEL
+	outBuf->catf("Content-Type: application/%s\r\n", (binaryResponse) ? "cbor" : "json");
+	if (sendingModel)
+	{
+		// We don't know the length of the response yet, so the client must read until we close the connection
+		keepOpen = false;
+	}
+	else
+#else
+	outBuf->cat("Content-Type: application/json\r\n");
+#endif
+	{
+		const unsigned int replyLength = (jsonResponse != nullptr) ? jsonResponse->Length() : 0;
+		outBuf->catf("Content-Length: %u\r\n", replyLength);
+	}
 	outBuf->catf("Connection: %s\r\n\r\n", keepOpen ? "keep-alive" : "close");
 	outBuf->Append(jsonResponse);
 
@@ -1049,6 +1090,9 @@ void HttpResponder::SendJsonResponse(const char* command) noexcept
 		// We ran out of buffers at some point.
 		// DC 2020-05-05: we no longer retry or discard responses if there are no buffers available, instead we return a 503 error immediately
 		ReportOutputBufferExhaustion(__FILE__, __LINE__);
+#if SUPPORT_OBJECT_MODEL
+		sendingModel = false;
+#endif
 
 		// We know that we have an output buffer, but it may be too short to send a long reply, so send a short one
 		outBuf->copy(serviceUnavailableResponse);
@@ -1359,6 +1403,63 @@ void HttpResponder::SendData() noexcept
 	}
 }
 
+#if SUPPORT_OBJECT_MODEL
+
+// Generate the next part of a whole object model response in outBuf. Return false if there is nothing more to generate.
+// If we return true with outBuf still null then either there was no buffer available, or we gave up and dropped the connection.
+bool HttpResponder::GetMoreOutput() noexcept
+{
+	if (!sendingModel)
+	{
+		return false;
+	}
+
+	if (OutputBuffer::Allocate(outBuf))
+	{
+		const size_t oldCursor = modelCursor;
+		bool more;
+		try
+		{
+			more = reprap.ReportNextEntryAsJson(outBuf, modelFlags.c_str(), modelCursor, !modelEntrySent);
+		}
+		catch (const GCodeException&)
+		{
+			// The response would be invalid JSON if we carried on, so abandon it
+			OutputBuffer::ReleaseAll(outBuf);
+			sendingModel = false;
+			ConnectionLost();
+			return true;
+		}
+
+		if (!more && !binaryResponse)
+		{
+			outBuf->cat('}');					// the result object has been closed, so close the response object too
+		}
+
+		if (!outBuf->HadOverflow())
+		{
+			modelEntrySent |= more;
+			sendingModel = more;
+			timer = millis();
+			return true;
+		}
+
+		// We ran out of buffers while generating this part, so free them up and try again later
+		OutputBuffer::ReleaseAll(outBuf);
+		modelCursor = oldCursor;
+	}
+
+	if (millis() - timer >= MaxBufferWaitTime)
+	{
+		ReportOutputBufferExhaustion(__FILE__, __LINE__);
+		sendingModel = false;
+		ConnectionLost();
+	}
+	return true;
+}
+
+#endif
+
 void HttpResponder::Diagnostics(MessageType mt) const noexcept
 {
 	GetPlatform().MessageF(mt, " HTTP(%d)", (int)responderState);
@@ -30,6 +30,9 @@ public:
 protected:
 	void CancelUpload() noexcept override;
 	void SendData() noexcept override;
+#if SUPPORT_OBJECT_MODEL
+	bool GetMoreOutput() noexcept override;
+#endif
 
 private:
 #ifdef __LPC17xx__
@@ -120,6 +123,15 @@ private:
 	time_t fileLastModified;
 	bool postFileGotCrc;
 
+#if SUPPORT_OBJECT_MODEL
+	// rr_model requests for the whole object model are sent one top-level key at a time, so that they don't need enough output buffers to hold the whole response
+	String<StringLength20> modelFlags;				// the flags from the request
+	size_t modelCursor;								// index of the next root table entry to consider
+	bool sendingModel;								// true if we are generating the response while sending it
+	bool modelEntrySent;							// true if we have sent at least one entry
+	bool binaryResponse;							// true if the response is encoded in CBOR instead of JSON
+#endif
+
 	// Keeping track of HTTP sessions
 	static HttpSession sessions[MaxHttpSessions];
 	static unsigned int numSessions;
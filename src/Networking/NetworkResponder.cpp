@@ -37,7 +37,7 @@ void NetworkResponder::Commit(ResponderState nextState, bool report) noexcept
 }
 
 // Send our data.
-// We send outBuf first, then outStack, and finally fileBeingSent.
+// We send outBuf first, then outStack, then any response that is generated a piece at a time, and finally fileBeingSent.
 void NetworkResponder::SendData() noexcept
 {
 	// Send our output buffer and output stack
@@ -48,7 +48,14 @@ void NetworkResponder::SendData() noexcept
 			outBuf = outStack.Pop();
 			if (outBuf == nullptr)
 			{
-				break;
+				if (!GetMoreOutput())
+				{
+					break;
+				}
+				if (outBuf == nullptr)
+				{
+					return;					// the next part isn't ready yet, or the connection has been lost
+				}
 			}
 		}
 		const size_t bytesLeft = outBuf->BytesLeft();
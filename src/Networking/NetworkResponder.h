@@ -61,6 +61,7 @@ protected:
 	void Commit(ResponderState nextState = ResponderState::free, bool report = true) noexcept;
 	virtual void SendData() noexcept;
 	virtual void ConnectionLost() noexcept;
+	virtual bool GetMoreOutput() noexcept { return false; }	// generate the next part of a long response in outBuf, returning true if there is or may be more to send
 
 	IPAddress GetRemoteIP() const noexcept;
 	void ReportOutputBufferExhaustion(const char *sourceFile, int line) noexcept;
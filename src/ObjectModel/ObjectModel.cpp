@@ -213,8 +213,8 @@ ObjectModel::ObjectModel() noexcept
 
 ObjectExplorationContext::ObjectExplorationContext(const char *reportFlags, bool wal, unsigned int initialMaxDepth, int p_line, int p_col) noexcept
 	: maxDepth(initialMaxDepth), currentDepth(0), numIndicesProvided(0), numIndicesCounted(0),
-	  line(p_line), column(p_col),
-	  shortForm(false), onlyLive(false), includeVerbose(false), wantArrayLength(wal), includeNulls(false)
+	  pathCacheEntry(nullptr), pathStep(0), changedSince(0), line(p_line), column(p_col),
+	  shortForm(false), onlyLive(false), includeVerbose(false), wantArrayLength(wal), includeNulls(false), wantChangesOnly(false), wantBinary(false)
 {
 	while (true)
 	{
@@ -234,6 +234,18 @@ ObjectExplorationContext::ObjectExplorationContext(const char *reportFlags, bool
 		case 'n':
 			includeNulls = true;
 			break;
+		case 'b':
+			wantBinary = true;
+			break;
+		case 'c':
+			wantChangesOnly = true;
+			changedSince = 0;
+			while (isdigit(*reportFlags))
+			{
+				changedSince = (10 * changedSince) + (*reportFlags - '0');
+				++reportFlags;
+			}
+			break;
 		case 'd':
 			maxDepth = 0;
 			while (isdigit(*reportFlags))
@@ -276,6 +288,43 @@ bool ObjectExplorationContext::ShouldReport(const ObjectModelEntryFlags f) const
 		&& (includeVerbose || ((uint8_t)f & (uint8_t)ObjectModelEntryFlags::verbose) == 0);
 }
 
+// If the current step of the path was cached and still matches, return the cached table entry and update the class descriptor to the one that contains it, else return null
+const ObjectModelTableEntry *ObjectExplorationContext::FindCachedTableEntry(const ObjectModelClassDescriptor *& classDescriptor, uint8_t tableNumber, const char *idString) noexcept
+{
+	if (pathCacheEntry != nullptr && pathStep < pathCacheEntry->numSteps)
+	{
+		const ObjectModelPathCacheEntry::Step& step = pathCacheEntry->steps[pathStep];
+		if (step.startDescriptor == classDescriptor && step.tableNumber == tableNumber && step.entry->IdCompare(idString) == 0)
+		{
+			++pathStep;
+			classDescriptor = step.foundDescriptor;
+			return step.entry;
+		}
+	}
+	return nullptr;
+}
+
+// Record the table entry that we found by searching for the current step of the path
+void ObjectExplorationContext::CacheTableEntry(const ObjectModelClassDescriptor *startDescriptor, const ObjectModelClassDescriptor *foundDescriptor, uint8_t tableNumber, const ObjectModelTableEntry *entry) noexcept
+{
+	if (pathCacheEntry != nullptr)
+	{
+		if (pathStep < ObjectModelPathCacheEntry::MaxSteps)
+		{
+			ObjectModelPathCacheEntry::Step& step = pathCacheEntry->steps[pathStep];
+			step.startDescriptor = startDescriptor;
+			step.foundDescriptor = foundDescriptor;
+			step.tableNumber = tableNumber;
+			step.entry = entry;
+			if (pathStep >= pathCacheEntry->numSteps)
+			{
+				pathCacheEntry->numSteps = pathStep + 1;
+			}
+		}
+		++pathStep;
+	}
+}
+
 GCodeException ObjectExplorationContext::ConstructParseException(const char *msg) const noexcept
 {
 	return GCodeException(line, column, msg);
@@ -286,6 +335,43 @@ GCodeException ObjectExplorationContext::ConstructParseException(const char *msg
 	return GCodeException(line, column, msg, sparam);
 }
 
+// Helper functions for the parts of a report that are encoded differently in JSON and CBOR
+static void ReportNull(OutputBuffer *buf, const ObjectExplorationContext& context) noexcept
+{
+	if (context.WantBinary())
+	{
+		buf->cat(OutputBuffer::CborNull);
+	}
+	else
+	{
+		buf->cat("null");
+	}
+}
+
+static void ReportEmptyObject(OutputBuffer *buf, const ObjectExplorationContext& context) noexcept
+{
+	if (context.WantBinary())
+	{
+		buf->cat(OutputBuffer::CborEmptyMap);
+	}
+	else
+	{
+		buf->cat("{}");
+	}
+}
+
+static void ReportUnsigned(OutputBuffer *buf, const ObjectExplorationContext& context, uint32_t val) noexcept
+{
+	if (context.WantBinary())
+	{
+		buf->CborHead(OutputBuffer::CborUnsignedInt, val);
+	}
+	else
+	{
+		buf->catf("%" PRIu32, val);
+	}
+}
+
 // Report this object
 void ObjectModel::ReportAsJson(OutputBuffer* buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor,
 								uint8_t tableNumber, const char* filter) const THROWS(GCodeException)
@@ -312,12 +398,9 @@ void ObjectModel::ReportAsJson(OutputBuffer* buf, ObjectExplorationContext& cont
 				size_t numEntries = descriptor[tableNumber + 1];
 				while (numEntries != 0)
 				{
-					if (tbl->Matches(filter, context))
+					if (ReportTableEntryAsJson(buf, context, classDescriptor, tbl, filter, !added))
 					{
-						if (tbl->ReportAsJson(buf, context, classDescriptor, this, filter, !added))
-						{
-							added = true;
-						}
+						added = true;
 					}
 					--numEntries;
 					++tbl;
@@ -334,18 +417,22 @@ void ObjectModel::ReportAsJson(OutputBuffer* buf, ObjectExplorationContext& cont
 		{
 			if (*filter == 0)
 			{
-				buf->cat('}');
+				buf->cat((context.WantBinary()) ? OutputBuffer::CborBreak : '}');
 			}
 		}
+		else if (*filter == 0)
+		{
+			ReportEmptyObject(buf, context);
+		}
 		else
 		{
-			buf->cat((*filter == 0) ? "{}" : "null");
+			ReportNull(buf, context);
 		}
 		context.DecreaseDepth();
 	}
 	else
 	{
-		buf->cat("{}");
+		ReportEmptyObject(buf, context);
 	}
 }
 
@@ -357,6 +444,58 @@ void ObjectModel::ReportAsJson(OutputBuffer *buf, const char *filter, const char
 	ReportAsJson(buf, context, nullptr, 0, filter);
 }
 
+// Return true if the flags ask for the report to be encoded in CBOR
+/*static*/ bool ObjectModel::IsBinaryReport(const char *reportFlags) noexcept
+{
+	return ObjectExplorationContext(reportFlags, false, 0).WantBinary();
+}
+
+// Report a single table entry as JSON if the context selects it, returning true if we did
+bool ObjectModel::ReportTableEntryAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ObjectModelTableEntry *tbl,
+											const char *filter, bool first) const THROWS(GCodeException)
+{
+	// If the client only wants what has changed since its previous query, we only need the live values of top-level entries that haven't changed
+	const bool wasOnlyLive = context.OnlyLive();
+	if (context.WantChangesOnly() && context.GetCurrentDepth() == 1 && !HasChangedSince(tbl, context.GetChangedSince()))
+	{
+		context.SetOnlyLive(true);
+	}
+	const bool added = tbl->Matches(filter, context) && tbl->ReportAsJson(buf, context, classDescriptor, this, filter, first);
+	context.SetOnlyLive(wasOnlyLive);
+	return added;
+}
+
+// Report the next entry in the root table that the flags select as JSON. This is used to send the whole object model a piece at a time.
+// The context doesn't need to be kept between calls because at the top level the only state it holds comes from the flags.
+// When there are no more entries we close the object, or report an empty one if there were no entries at all.
+bool ObjectModel::ReportNextEntryAsJson(OutputBuffer *buf, const char *reportFlags, size_t& cursor, bool first) const THROWS(GCodeException)
+{
+	ObjectExplorationContext context(reportFlags, false, 1);
+	if (context.IncreaseDepth())
+	{
+		const ObjectModelClassDescriptor * const classDescriptor = GetObjectModelClassDescriptor();
+		const size_t numEntries = classDescriptor->omd[1];
+		while (cursor < numEntries)
+		{
+			const ObjectModelTableEntry * const tbl = &classDescriptor->omt[cursor++];
+			if (ReportTableEntryAsJson(buf, context, classDescriptor, tbl, "", first))
+			{
+				return true;
+			}
+		}
+	}
+
+	if (first)
+	{
+		ReportEmptyObject(buf, context);
+	}
+	else
+	{
+		buf->cat((context.WantBinary()) ? OutputBuffer::CborBreak : '}');
+	}
+	return false;
+}
+
 // Function to report a value or object as JSON
 // This function is recursive, so keep its stack usage low.
 // Most recursive calls are for non-array object values, so handle object values inline to reduce stack usage.
@@ -376,7 +515,7 @@ inline void ObjectModel::ReportItemAsJson(OutputBuffer *buf, ObjectExplorationCo
 		}
 		else if (*filter != 0)
 		{
-			buf->cat("null");						// error, should have reached the end of the filter or a '.'
+			ReportNull(buf, context);				// error, should have reached the end of the filter or a '.'
 			return;
 		}
 		val.omVal->ReportAsJson(buf, context, (val.omVal == this) ? classDescriptor : nullptr, val.param, filter);
@@ -392,24 +531,24 @@ void ObjectModel::ReportArrayLengthAsJson(OutputBuffer *buf, ObjectExplorationCo
 	switch (val.GetType())
 	{
 	case TypeCode::Array:
-		buf->catf("%u", val.omadVal->GetNumElements(this, context));
+		ReportUnsigned(buf, context, val.omadVal->GetNumElements(this, context));
 		break;
 
 	case TypeCode::Bitmap16:
 	case TypeCode::Bitmap32:
-		buf->catf("%u", Bitmap<uint32_t>::MakeFromRaw(val.uVal).CountSetBits());
+		ReportUnsigned(buf, context, Bitmap<uint32_t>::MakeFromRaw(val.uVal).CountSetBits());
 		break;
 
 	case TypeCode::Bitmap64:
-		buf->catf("%u", Bitmap<uint64_t>::MakeFromRaw(val.Get56BitValue()).CountSetBits());
+		ReportUnsigned(buf, context, Bitmap<uint64_t>::MakeFromRaw(val.Get56BitValue()).CountSetBits());
 		break;
 
 	case TypeCode::CString:
-		buf->catf("%u", strlen(val.sVal));
+		ReportUnsigned(buf, context, strlen(val.sVal));
 		break;
 
 	default:
-		buf->cat("null");
+		ReportNull(buf, context);
 		break;
 	}
 }
@@ -435,12 +574,19 @@ void ObjectModel::ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationConte
 				const int32_t index = StrToI32(filter, &endptr);
 				if (endptr == filter || *endptr != ']' || index < 0 || (size_t)index >= val.omadVal->GetNumElements(this, context))
 				{
-					buf->cat("null");					// avoid returning badly-formed JSON
+					ReportNull(buf, context);			// avoid returning badly-formed JSON
 					break;								// invalid syntax, or index out of range
 				}
 				if (*filter == 0)
 				{
-					buf->cat('[');
+					if (context.WantBinary())
+					{
+						buf->CborHead(OutputBuffer::CborArray, 1);
+					}
+					else
+					{
+						buf->cat('[');
+					}
 				}
 				context.AddIndex(index);
 				{
@@ -450,7 +596,7 @@ void ObjectModel::ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationConte
 					ReportItemAsJson(buf, context, classDescriptor, element, endptr + 1);
 				}
 				context.RemoveIndex();
-				if (*filter == 0)
+				if (*filter == 0 && !context.WantBinary())
 				{
 					buf->cat(']');
 				}
@@ -462,33 +608,54 @@ void ObjectModel::ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationConte
 		}
 		else
 		{
-			buf->cat("null");
+			ReportNull(buf, context);
 		}
 		break;
 
 	case TypeCode::Float:
-		ReportFloat(buf, val);
+		ReportFloat(buf, context, val);
 		break;
 
 	case TypeCode::Uint32:
-		buf->catf("%" PRIu32, val.uVal);
+		ReportUnsigned(buf, context, val.uVal);
 		break;
 
 	case TypeCode::Uint64:
-		buf->catf("%" PRIu64, ((uint64_t)val.param << 32) | val.uVal);	// convert unsigned integer to string
+		if (context.WantBinary())
+		{
+			buf->CborHead(OutputBuffer::CborUnsignedInt, ((uint64_t)val.param << 32) | val.uVal);
+		}
+		else
+		{
+			buf->catf("%" PRIu64, ((uint64_t)val.param << 32) | val.uVal);	// convert unsigned integer to string
+		}
 		break;
 
 	case TypeCode::Int32:
-		buf->catf("%" PRIi32, val.iVal);
+		if (context.WantBinary())
+		{
+			buf->CborSigned(val.iVal);
+		}
+		else
+		{
+			buf->catf("%" PRIi32, val.iVal);
+		}
 		break;
 
 	case TypeCode::CString:
-		buf->EncodeString(val.sVal, true);
+		if (context.WantBinary())
+		{
+			buf->CborString(val.sVal, true);
+		}
+		else
+		{
+			buf->EncodeString(val.sVal, true);
+		}
 		break;
 
 #ifdef DUET3
 	case TypeCode::CanExpansionBoardDetails:
-		ReportExpansionBoardDetail(buf, val);
+		ReportExpansionBoardDetail(buf, context, val);
 		break;
 #endif
 
@@ -507,22 +674,22 @@ void ObjectModel::ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationConte
 				const int32_t index = StrToI32(filter, &endptr);
 				if (endptr == filter || *endptr != ']' || index < 0 || (size_t)index >= val.omadVal->GetNumElements(this, context))
 				{
-					buf->cat("null");				// avoid returning badly-formed JSON
+					ReportNull(buf, context);		// avoid returning badly-formed JSON
 					break;							// invalid syntax, or index out of range
 				}
 				const auto bm = Bitmap<uint32_t>::MakeFromRaw(val.uVal);
-				buf->catf("%u", bm.GetSetBitNumber(index));
+				ReportUnsigned(buf, context, bm.GetSetBitNumber(index));
 				break;
 			}
 		}
 		else if (context.ShortFormReport())
 		{
-			buf->catf("%" PRIu32, val.uVal);
+			ReportUnsigned(buf, context, val.uVal);
 			break;
 		}
 
 		// If we get here then we want a long form report
-		ReportBitmap1632Long(buf, val);
+		ReportBitmap1632Long(buf, context, val);
 		break;
 
 	case TypeCode::Bitmap64:
@@ -539,28 +706,39 @@ void ObjectModel::ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationConte
 				const int32_t index = StrToI32(filter, &endptr);
 				if (endptr == filter || *endptr != ']' || index < 0 || (size_t)index >= val.omadVal->GetNumElements(this, context))
 				{
-					buf->cat("null");				// avoid returning badly-formed JSON
+					ReportNull(buf, context);		// avoid returning badly-formed JSON
 					break;							// invalid syntax, or index out of range
 				}
 				const auto bm = Bitmap<uint64_t>::MakeFromRaw(val.uVal);
-				buf->catf("%u", bm.GetSetBitNumber(index));
+				ReportUnsigned(buf, context, bm.GetSetBitNumber(index));
 				break;
 			}
 		}
 		else if (context.ShortFormReport())
 		{
-			buf->catf("%" PRIu64, val.Get56BitValue());
+			if (context.WantBinary())
+			{
+				buf->CborHead(OutputBuffer::CborUnsignedInt, val.Get56BitValue());
+			}
+			else
+			{
+				buf->catf("%" PRIu64, val.Get56BitValue());
+			}
 			break;
 		}
 
 		// If we get here then we want a long form report
-		ReportBitmap64Long(buf, val);
+		ReportBitmap64Long(buf, context, val);
 		break;
 
 	case TypeCode::Enum32:
 		if (context.ShortFormReport())
 		{
-			buf->catf("%" PRIu32, val.uVal);
+			ReportUnsigned(buf, context, val.uVal);
+		}
+		else if (context.WantBinary())
+		{
+			buf->CborString("unimplemented", false);
 		}
 		else
 		{
@@ -570,42 +748,51 @@ void ObjectModel::ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationConte
 		break;
 
 	case TypeCode::Bool:
-		buf->cat((val.bVal) ? "true" : "false");
+		if (context.WantBinary())
+		{
+			buf->cat((val.bVal) ? OutputBuffer::CborTrue : OutputBuffer::CborFalse);
+		}
+		else
+		{
+			buf->cat((val.bVal) ? "true" : "false");
+		}
 		break;
 
 	case TypeCode::Char:
-		buf->cat('"');
-		buf->EncodeChar(val.cVal);
-		buf->cat('"');
+		if (context.WantBinary())
+		{
+			const char str[2] = { val.cVal, 0 };
+			buf->CborString(str, true);
+		}
+		else
+		{
+			buf->cat('"');
+			buf->EncodeChar(val.cVal);
+			buf->cat('"');
+		}
 		break;
 
 	case TypeCode::IPAddress:
 		{
 			const IPAddress ipVal(val.uVal);
-			char sep = '"';
-			for (unsigned int q = 0; q < 4; ++q)
-			{
-				buf->catf("%c%u", sep, ipVal.GetQuad(q));
-				sep = '.';
-			}
-			buf->cat('"');
+			ReportFormattedString(buf, context, "%u.%u.%u.%u", ipVal.GetQuad(0), ipVal.GetQuad(1), ipVal.GetQuad(2), ipVal.GetQuad(3));
 		}
 		break;
 
 	case TypeCode::DateTime:
-		ReportDateTime(buf, val);
+		ReportDateTime(buf, context, val);
 		break;
 
 	case TypeCode::DriverId:
 #if SUPPORT_CAN_EXPANSION
-		buf->catf("\"%u.%u\"", (unsigned int)(val.uVal >> 8), (unsigned int)(val.uVal & 0xFF));
+		ReportFormattedString(buf, context, "%u.%u", (unsigned int)(val.uVal >> 8), (unsigned int)(val.uVal & 0xFF));
 #else
-		buf->catf("\"%u\"", (unsigned int)val.uVal);
+		ReportFormattedString(buf, context, "%u", (unsigned int)val.uVal);
 #endif
 		break;
 
 	case TypeCode::MacAddress:
-		buf->catf("\"%02x:%02x:%02x:%02x:%02x:%02x\"",
+		ReportFormattedString(buf, context, "%02x:%02x:%02x:%02x:%02x:%02x",
 					(unsigned int)(val.uVal & 0xFF), (unsigned int)((val.uVal >> 8) & 0xFF), (unsigned int)((val.uVal >> 16) & 0xFF), (unsigned int)((val.uVal >> 24) & 0xFF),
 					(unsigned int)(val.param & 0xFF), (unsigned int)((val.param >> 8) & 0xFF));
 		break;
@@ -615,14 +802,14 @@ void ObjectModel::ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationConte
 		switch ((ExpressionValue::SpecialType)val.param)
 		{
 		case ExpressionValue::SpecialType::sysDir:
-			reprap.GetPlatform().EncodeSysDir(buf);
+			reprap.GetPlatform().EncodeSysDir(buf, context.WantBinary());
 			break;
 		}
 #endif
 		break;
 
 	case TypeCode::None:
-		buf->cat("null");
+		ReportNull(buf, context);
 		break;
 
 	case TypeCode::ObjectModel:
@@ -636,11 +823,18 @@ void ObjectModel::ReportArrayAsJson(OutputBuffer *buf, ObjectExplorationContext&
 {
 	ReadLocker lock(omad->lockPointer);
 
-	buf->cat('[');
 	const size_t count = omad->GetNumElements(this, context);
+	if (context.WantBinary())
+	{
+		buf->CborHead(OutputBuffer::CborArray, count);		// we know the number of elements, so we don't need a terminator
+	}
+	else
+	{
+		buf->cat('[');
+	}
 	for (size_t i = 0; i < count; ++i)
 	{
-		if (i != 0)
+		if (i != 0 && !context.WantBinary())
 		{
 			buf->cat(',');
 		}
@@ -649,7 +843,10 @@ void ObjectModel::ReportArrayAsJson(OutputBuffer *buf, ObjectExplorationContext&
 		ReportItemAsJson(buf, context, classDescriptor, element, filter);
 		context.RemoveIndex();
 	}
-	buf->cat(']');
+	if (!context.WantBinary())
+	{
+		buf->cat(']');
+	}
 }
 
 // Find the requested entry
@@ -716,9 +913,20 @@ bool ObjectModelTableEntry::ReportAsJson(OutputBuffer* buf, ObjectExplorationCon
 	{
 		if (*filter == 0)
 		{
-			buf->cat((first) ? "{\"" : ",\"");
-			buf->cat(name);
-			buf->cat("\":");
+			if (context.WantBinary())
+			{
+				if (first)
+				{
+					buf->cat(OutputBuffer::CborStartMap);
+				}
+				buf->CborString(name, false);
+			}
+			else
+			{
+				buf->cat((first) ? "{\"" : ",\"");
+				buf->cat(name);
+				buf->cat("\":");
+			}
 		}
 		self->ReportItemAsJson(buf, context, classDescriptor, val, nextElement);
 		return true;
@@ -753,23 +961,24 @@ ExpressionValue ObjectModel::GetObjectValue(ObjectExplorationContext& context, c
 		classDescriptor = GetObjectModelClassDescriptor();
 	}
 
-	while (classDescriptor != nullptr)
+	const ObjectModelClassDescriptor * const startDescriptor = classDescriptor;
+	const ObjectModelTableEntry *e = context.FindCachedTableEntry(classDescriptor, tableNumber, idString);
+	while (e == nullptr)
 	{
-		const ObjectModelTableEntry * const e = FindObjectModelTableEntry(classDescriptor, tableNumber, idString);
+		e = FindObjectModelTableEntry(classDescriptor, tableNumber, idString);
 		if (e != nullptr)
 		{
-			idString = GetNextElement(idString);
-			const ExpressionValue val = e->func(this, context);
-			return GetObjectValue(context, classDescriptor, val, idString);
+			context.CacheTableEntry(startDescriptor, classDescriptor, tableNumber, e);
 		}
-		if (tableNumber != 0)
+		else if (tableNumber != 0 || (classDescriptor = classDescriptor->parent) == nullptr)		// search parent class object model too
 		{
-			break;
+			throw context.ConstructParseException("unknown value '%s'", idString);
 		}
-		classDescriptor = classDescriptor->parent;			// search parent class object model too
 	}
 
-	throw context.ConstructParseException("unknown value '%s'", idString);
+	idString = GetNextElement(idString);
+	const ExpressionValue val = e->func(this, context);
+	return GetObjectValue(context, classDescriptor, val, idString);
 }
 
 ExpressionValue ObjectModel::GetObjectValue(ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ExpressionValue& val, const char *idString) const
@@ -924,25 +1133,29 @@ ExpressionValue ObjectModel::GetObjectValue(ObjectExplorationContext& context, c
 }
 
 // Separate function to avoid the tm object (44 bytes) being allocated on the stack frame of a recursive function
-void ObjectModel::ReportDateTime(OutputBuffer *buf, const ExpressionValue& val) noexcept
+void ObjectModel::ReportDateTime(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept
 {
 	const time_t time = val.Get56BitValue();
 	tm timeInfo;
 	gmtime_r(&time, &timeInfo);
-	buf->catf("\"%04u-%02u-%02uT%02u:%02u:%02u\"",
-				timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday, timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec);
+	ReportFormattedString(buf, context, "%04u-%02u-%02uT%02u:%02u:%02u",
+							timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday, timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec);
 }
 
 // Separate function to avoid a recursive function saving all the FP registers
-void ObjectModel::ReportFloat(OutputBuffer *buf, const ExpressionValue& val) noexcept
+void ObjectModel::ReportFloat(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept
 {
 	if (val.fVal == 0.0)
 	{
-		buf->cat('0');							// replace 0.000... in JSON by 0. This is mostly to save space when writing workplace coordinates.
+		buf->cat((context.WantBinary()) ? '\0' : '0');	// replace 0.000... in JSON by 0. This is mostly to save space when writing workplace coordinates.
 	}
 	else if (isnan(val.fVal) || isinf(val.fVal))
 	{
-		buf->cat("null");						// avoid generating bad JSON if the value is a NaN or infinity
+		ReportNull(buf, context);						// avoid generating bad JSON if the value is a NaN or infinity
+	}
+	else if (context.WantBinary())
+	{
+		buf->CborFloat(val.fVal);						// this is much faster than formatting the value as text
 	}
 	else
 	{
@@ -950,9 +1163,16 @@ void ObjectModel::ReportFloat(OutputBuffer *buf, const ExpressionValue& val) noe
 	}
 }
 
-void ObjectModel::ReportBitmap1632Long(OutputBuffer *buf, const ExpressionValue& val) noexcept
+void ObjectModel::ReportBitmap1632Long(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept
 {
 	const auto bm = Bitmap<uint32_t>::MakeFromRaw(val.uVal);
+	if (context.WantBinary())
+	{
+		buf->CborHead(OutputBuffer::CborArray, bm.CountSetBits());
+		bm.Iterate([buf](unsigned int bn, unsigned int) noexcept { buf->CborHead(OutputBuffer::CborUnsignedInt, bn); });
+		return;
+	}
+
 	buf->cat('[');
 	bm.Iterate
 		([buf](unsigned int bn, unsigned int count) noexcept
@@ -967,9 +1187,16 @@ void ObjectModel::ReportBitmap1632Long(OutputBuffer *buf, const ExpressionValue&
 	buf->cat(']');
 }
 
-void ObjectModel::ReportBitmap64Long(OutputBuffer *buf, const ExpressionValue& val) noexcept
+void ObjectModel::ReportBitmap64Long(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept
 {
 	const auto bm = Bitmap<uint64_t>::MakeFromRaw(val.Get56BitValue());
+	if (context.WantBinary())
+	{
+		buf->CborHead(OutputBuffer::CborArray, bm.CountSetBits());
+		bm.Iterate([buf](unsigned int bn, unsigned int) noexcept { buf->CborHead(OutputBuffer::CborUnsignedInt, bn); });
+		return;
+	}
+
 	buf->cat('[');
 	bm.Iterate
 		([buf](unsigned int bn, unsigned int count) noexcept
@@ -984,14 +1211,42 @@ void ObjectModel::ReportBitmap64Long(OutputBuffer *buf, const ExpressionValue& v
 	buf->cat(']');
 }
 
+// Report a value that is always reported as a string, such as an IP address. It must not need escaping in JSON.
+// Separate function to avoid the string being allocated on the stack frame of a recursive function
+void ObjectModel::ReportFormattedString(OutputBuffer *buf, const ObjectExplorationContext& context, const char *fmt, ...) noexcept
+{
+	String<StringLength50> rslt;
+	va_list vargs;
+	va_start(vargs, fmt);
+	rslt.vprintf(fmt, vargs);
+	va_end(vargs);
+	if (context.WantBinary())
+	{
+		buf->CborString(rslt.c_str(), false);
+	}
+	else
+	{
+		buf->cat('"');
+		buf->cat(rslt.c_str());
+		buf->cat('"');
+	}
+}
+
 #ifdef DUET3
 
 // Separate functions to avoid the string being allocated on the stack frame of a recursive function
-void ObjectModel::ReportExpansionBoardDetail(OutputBuffer *buf, const ExpressionValue& val) noexcept
+void ObjectModel::ReportExpansionBoardDetail(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept
 {
 	String<StringLength50> rslt;
 	val.ExtractRequestedPart(rslt.GetRef());
-	buf->EncodeString(rslt.c_str(), true);
+	if (context.WantBinary())
+	{
+		buf->CborString(rslt.c_str(), true);
+	}
+	else
+	{
+		buf->EncodeString(rslt.c_str(), true);
+	}
 }
 
 ExpressionValue ObjectModel::GetExpansionBoardDetailLength(const ExpressionValue& val) noexcept
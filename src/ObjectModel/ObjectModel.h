@@ -161,6 +161,28 @@ enum class ObjectModelEntryFlags : uint8_t
 	liveCanAlter = 5,		// we can alter this value
 };
 
+struct ObjectModelClassDescriptor;
+
+// Record of the table entries that an object model path resolved to the last time it was looked up.
+// Expressions in macros are often evaluated many times (e.g. in loops), so this saves searching the tables by name each time.
+// Each step is checked against the path before it is used, so a stale entry just causes the normal search to be done.
+struct ObjectModelPathCacheEntry
+{
+	static constexpr size_t MaxSteps = 4;
+
+	struct Step
+	{
+		const ObjectModelClassDescriptor *startDescriptor;			// the class descriptor we started searching from
+		const ObjectModelClassDescriptor *foundDescriptor;			// the class descriptor whose table contains the entry, which may be a parent of startDescriptor
+		const ObjectModelTableEntry *entry;
+		uint8_t tableNumber;
+	};
+
+	uint32_t pathHash;
+	size_t numSteps;
+	Step steps[MaxSteps];
+};
+
 // Context passed to object model functions
 class ObjectExplorationContext
 {
@@ -181,10 +203,20 @@ public:
 	bool ShouldReport(const ObjectModelEntryFlags f) const noexcept;
 	bool WantArrayLength() const noexcept { return wantArrayLength; }
 	bool ShouldIncludeNulls() const noexcept { return includeNulls; }
+	bool WantChangesOnly() const noexcept { return wantChangesOnly; }
+	uint32_t GetChangedSince() const noexcept { return changedSince; }
+	unsigned int GetCurrentDepth() const noexcept { return currentDepth; }
+	bool OnlyLive() const noexcept { return onlyLive; }
+	void SetOnlyLive(bool b) noexcept { onlyLive = b; }
+	bool WantBinary() const noexcept { return wantBinary; }
 
 	GCodeException ConstructParseException(const char *msg) const noexcept;
 	GCodeException ConstructParseException(const char *msg, const char *sparam) const noexcept;
 
+	void SetPathCacheEntry(ObjectModelPathCacheEntry *p) noexcept { pathCacheEntry = p; pathStep = 0; }
+	const ObjectModelTableEntry *FindCachedTableEntry(const ObjectModelClassDescriptor *& classDescriptor, uint8_t tableNumber, const char *idString) noexcept;
+	void CacheTableEntry(const ObjectModelClassDescriptor *startDescriptor, const ObjectModelClassDescriptor *foundDescriptor, uint8_t tableNumber, const ObjectModelTableEntry *entry) noexcept;
+
 private:
 	static constexpr size_t MaxIndices = 4;			// max depth of array nesting
 
@@ -193,6 +225,9 @@ private:
 	size_t numIndicesProvided;						// the number of indices provided, when we are doing a value lookup
 	size_t numIndicesCounted;						// the number of indices passed in the search string
 	int32_t indices[MaxIndices];
+	ObjectModelPathCacheEntry *pathCacheEntry;		// if not null, the resolved path that we use and update when looking up values
+	size_t pathStep;								// how many table lookups we have done in the path so far
+	uint32_t changedSince;							// if wantChangesOnly is set, the model sequence number of the client's previous query
 	int line;
 	int column;
 	bool shortForm;
@@ -200,6 +235,8 @@ private:
 	bool includeVerbose;
 	bool wantArrayLength;
 	bool includeNulls;
+	bool wantChangesOnly;
+	bool wantBinary;								// true to report in CBOR instead of JSON
 };
 
 // Entry to describe an array of objects or values. These must be brace-initializable into flash memory.
@@ -221,11 +258,19 @@ public:
 	virtual ~ObjectModel() { }
 
 	// Construct a JSON representation of those parts of the object model requested by the user. This version is called on the root of the tree.
+	// If the flags include 'b' then the report is encoded in CBOR instead, with the same structure.
 	void ReportAsJson(OutputBuffer *buf, const char *filter, const char *reportFlags, bool wantArrayLength) const THROWS(GCodeException);
 
+	// Return true if the flags ask for the report to be encoded in CBOR
+	static bool IsBinaryReport(const char *reportFlags) noexcept;
+
 	// Get the value of an object via the table
 	ExpressionValue GetObjectValue(ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor, const char *idString, uint8_t tableNumber = 0) const THROWS(GCodeException);
 
+	// Report the next entry in the root table that the flags select as JSON, so that a large response can be generated a piece at a time while earlier pieces are being sent.
+	// 'cursor' is the index of the next table entry to consider, starting at 0. Return false if there were no more entries to report, in which case the object has been closed.
+	bool ReportNextEntryAsJson(OutputBuffer *buf, const char *reportFlags, size_t& cursor, bool first) const THROWS(GCodeException);
+
 	// Function to report a value or object as JSON
 	void ReportItemAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor,
 							const ExpressionValue& val, const char *filter) const THROWS(GCodeException);
@@ -237,6 +282,10 @@ protected:
 	// Construct a JSON representation of those parts of the object model requested by the user
 	void ReportAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor * null classDescriptor, uint8_t tableNumber, const char *filter) const THROWS(GCodeException);
 
+	// Report a single table entry as JSON if the context selects it, returning true if we did
+	bool ReportTableEntryAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ObjectModelTableEntry *tbl,
+								const char *filter, bool first) const THROWS(GCodeException);
+
 	// Report an entire array as JSON
 	void ReportArrayAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor, const ObjectModelArrayDescriptor *omad, const char *filter) const THROWS(GCodeException);
 
@@ -248,18 +297,23 @@ protected:
 
 	virtual const ObjectModelClassDescriptor *GetObjectModelClassDescriptor() const noexcept = 0;
 
+	// Return true if the value of this table entry may have changed since the specified object model sequence number. Only the root object keeps sequence numbers.
+	virtual bool HasChangedSince(const ObjectModelTableEntry *entry, uint32_t seq) const noexcept { return true; }
+
 private:
 	// These functions have been separated from ReportItemAsJson to avoid high stack usage in the recursive functions, therefore they must not be inlined
 	__attribute__ ((noinline)) void ReportArrayLengthAsJson(OutputBuffer *buf, ObjectExplorationContext& context, const ExpressionValue& val) const noexcept;
 	__attribute__ ((noinline)) void ReportItemAsJsonFull(OutputBuffer *buf, ObjectExplorationContext& context, const ObjectModelClassDescriptor *classDescriptor,
 															const ExpressionValue& val, const char *filter) const THROWS(GCodeException);
-	__attribute__ ((noinline)) static void ReportDateTime(OutputBuffer *buf, const ExpressionValue& val) noexcept;
-	__attribute__ ((noinline)) static void ReportFloat(OutputBuffer *buf, const ExpressionValue& val) noexcept;
-	__attribute__ ((noinline)) static void ReportBitmap1632Long(OutputBuffer *buf, const ExpressionValue& val) noexcept;
-	__attribute__ ((noinline)) static void ReportBitmap64Long(OutputBuffer *buf, const ExpressionValue& val) noexcept;
+	__attribute__ ((noinline)) static void ReportDateTime(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept;
+	__attribute__ ((noinline)) static void ReportFloat(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept;
+	__attribute__ ((noinline)) static void ReportBitmap1632Long(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept;
+	__attribute__ ((noinline)) static void ReportBitmap64Long(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept;
+	__attribute__ ((noinline)) static void ReportFormattedString(OutputBuffer *buf, const ObjectExplorationContext& context, const char *fmt, ...) noexcept
+												__attribute__ ((format (printf, 3, 4)));
 
 #ifdef DUET3
-	__attribute__ ((noinline)) static void ReportExpansionBoardDetail(OutputBuffer *buf, const ExpressionValue& val) noexcept;
+	__attribute__ ((noinline)) static void ReportExpansionBoardDetail(OutputBuffer *buf, const ObjectExplorationContext& context, const ExpressionValue& val) noexcept;
 	__attribute__ ((noinline)) static ExpressionValue GetExpansionBoardDetailLength(const ExpressionValue& val) noexcept;
 #endif
 
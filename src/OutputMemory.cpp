@@ -10,9 +10,9 @@
 #include "RepRap.h"
 #include <cstdarg>
 
-/*static*/ OutputBuffer * volatile OutputBuffer::freeOutputBuffers = nullptr;		// Messages may also be sent by ISRs,
-/*static*/ volatile size_t OutputBuffer::usedOutputBuffers = 0;						// so make these volatile.
-/*static*/ volatile size_t OutputBuffer::maxUsedOutputBuffers = 0;
+/*static*/ OutputBuffer * volatile OutputBuffer::freeOutputBuffers[NumSizeClasses] = { nullptr };	// Messages may also be sent by ISRs,
+/*static*/ volatile size_t OutputBuffer::usedOutputBuffers[NumSizeClasses] = { 0 };				// so make these volatile.
+/*static*/ volatile size_t OutputBuffer::maxUsedOutputBuffers[NumSizeClasses] = { 0 };
 
 //*************************************************************************************************
 // OutputBuffer class implementation
@@ -173,11 +173,11 @@ size_t OutputBuffer::copy(const char *src, size_t len) noexcept
 size_t OutputBuffer::cat(const char c) noexcept
 {
 	// See if we can append a char
-	if (last->dataLength == OUTPUT_BUFFER_SIZE)
+	if (last->dataLength == last->capacity)
 	{
 		// No - allocate a new item and copy the data
-		OutputBuffer *nextBuffer;
-		if (!Allocate(nextBuffer))
+		OutputBuffer * const nextBuffer = AllocateToExtend();
+		if (nextBuffer == nullptr)
 		{
 			// We cannot store any more data
 			hadOverflow = true;
@@ -216,11 +216,11 @@ size_t OutputBuffer::cat(const char *src, size_t len) noexcept
 	size_t copied = 0;
 	while (copied < len)
 	{
-		if (last->dataLength == OUTPUT_BUFFER_SIZE)
+		if (last->dataLength == last->capacity)
 		{
 			// The last buffer is full
-			OutputBuffer *nextBuffer;
-			if (!Allocate(nextBuffer))
+			OutputBuffer * const nextBuffer = AllocateToExtend();
+			if (nextBuffer == nullptr)
 			{
 				// We cannot store any more data, stop here
 				hadOverflow = true;
@@ -234,7 +234,7 @@ size_t OutputBuffer::cat(const char *src, size_t len) noexcept
 				item->last = last;
 			}
 		}
-		const size_t copyLength = min<size_t>(len - copied, OUTPUT_BUFFER_SIZE - last->dataLength);
+		const size_t copyLength = min<size_t>(len - copied, last->capacity - last->dataLength);
 		memcpy(last->data + last->dataLength, src + copied, copyLength);
 		last->dataLength += copyLength;
 		copied += copyLength;
@@ -335,6 +335,55 @@ size_t OutputBuffer::EncodeReply(OutputBuffer *src) noexcept
 	return bytesWritten;
 }
 
+// Append the head of a CBOR data item, using the shortest encoding of the value or length
+size_t OutputBuffer::CborHead(uint8_t majorType, uint64_t val) noexcept
+{
+	const char initialByte = (char)(majorType << 5);
+	if (val < 24)
+	{
+		return cat((char)(initialByte | (char)val));
+	}
+
+	const unsigned int numBytes = (val <= 0xFF) ? 1 : (val <= 0xFFFF) ? 2 : (val <= 0xFFFFFFFF) ? 4 : 8;
+	char bytes[9];
+	bytes[0] = initialByte | (char)((numBytes == 1) ? 24 : (numBytes == 2) ? 25 : (numBytes == 4) ? 26 : 27);
+	for (unsigned int i = numBytes; i != 0; --i)
+	{
+		bytes[i] = (char)val;						// CBOR is big-endian
+		val >>= 8;
+	}
+	return cat(bytes, numBytes + 1);
+}
+
+size_t OutputBuffer::CborSigned(int32_t val) noexcept
+{
+	return (val < 0) ? CborHead(CborNegativeInt, (uint64_t)(-1 - (int64_t)val)) : CborHead(CborUnsignedInt, (uint64_t)val);
+}
+
+// Append a float as a single-precision CBOR value
+size_t OutputBuffer::CborFloat(float val) noexcept
+{
+	uint32_t bits;
+	memcpy(&bits, &val, sizeof(bits));
+	const char bytes[5] = { '\xFA', (char)(bits >> 24), (char)(bits >> 16), (char)(bits >> 8), (char)bits };
+	return cat(bytes, sizeof(bytes));
+}
+
+// Append a CBOR text string. As with EncodeString, if control characters are not allowed then the string ends at the first one.
+size_t OutputBuffer::CborString(const char *src, bool allowControlChars) noexcept
+{
+	size_t len = 0;
+	if (src != nullptr)
+	{
+		while (src[len] != 0 && (src[len] >= ' ' || allowControlChars))
+		{
+			++len;
+		}
+	}
+	const size_t bytesWritten = CborHead(CborTextString, len);
+	return bytesWritten + cat(src, len);
+}
+
 #if HAS_MASS_STORAGE
 
 // Write all the data to file, but don't release the buffers
@@ -368,59 +417,101 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 // Initialise the output buffers manager
 /*static*/ void OutputBuffer::Init() noexcept
 {
-	freeOutputBuffers = nullptr;
+	freeOutputBuffers[NormalBuffer] = nullptr;
+	char *storage = new char[OUTPUT_BUFFER_COUNT * OUTPUT_BUFFER_SIZE];
 	for (size_t i = 0; i < OUTPUT_BUFFER_COUNT; i++)
 	{
-		freeOutputBuffers = new OutputBuffer(freeOutputBuffers);
+		freeOutputBuffers[NormalBuffer] = new OutputBuffer(freeOutputBuffers[NormalBuffer], storage, OUTPUT_BUFFER_SIZE, NormalBuffer);
+		storage += OUTPUT_BUFFER_SIZE;
+	}
+
+	freeOutputBuffers[LargeBuffer] = nullptr;
+	if (LARGE_OUTPUT_BUFFER_COUNT != 0)
+	{
+		storage = new char[LARGE_OUTPUT_BUFFER_COUNT * LARGE_OUTPUT_BUFFER_SIZE];
+		for (size_t i = 0; i < LARGE_OUTPUT_BUFFER_COUNT; i++)
+		{
+			freeOutputBuffers[LargeBuffer] = new OutputBuffer(freeOutputBuffers[LargeBuffer], storage, LARGE_OUTPUT_BUFFER_SIZE, LargeBuffer);
+			storage += LARGE_OUTPUT_BUFFER_SIZE;
+		}
 	}
 }
 
-// Allocates an output buffer instance which can be used for (large) string outputs. This must be thread safe. Not safe to call from interrupts!
-/*static*/ bool OutputBuffer::Allocate(OutputBuffer *&buf) noexcept
+// Allocate a buffer of the specified size class, returning nullptr if there are none left. This must be thread safe. Not safe to call from interrupts!
+/*static*/ OutputBuffer *OutputBuffer::AllocateFrom(uint8_t sc) noexcept
 {
-	{
-		TaskCriticalSectionLocker lock;
+	TaskCriticalSectionLocker lock;
 
-		buf = freeOutputBuffers;
-		if (buf != nullptr)
+	OutputBuffer * const buf = freeOutputBuffers[sc];
+	if (buf != nullptr)
+	{
+		freeOutputBuffers[sc] = buf->next;
+		usedOutputBuffers[sc]++;
+		if (usedOutputBuffers[sc] > maxUsedOutputBuffers[sc])
 		{
-			freeOutputBuffers = buf->next;
-			usedOutputBuffers++;
-			if (usedOutputBuffers > maxUsedOutputBuffers)
-			{
-				maxUsedOutputBuffers = usedOutputBuffers;
-			}
+			maxUsedOutputBuffers[sc] = usedOutputBuffers[sc];
+		}
 
-			// Initialise the buffer before we release the lock in case another task uses it immediately
-			buf->next = nullptr;
-			buf->last = buf;
-			buf->dataLength = buf->bytesRead = 0;
-			buf->references = 1;					// assume it's only used once by default
-			buf->isReferenced = false;
-			buf->hadOverflow = false;
-			buf->whenQueued = millis();				// use the time of allocation as the default when-used time
+		// Initialise the buffer before we release the lock in case another task uses it immediately
+		buf->next = nullptr;
+		buf->last = buf;
+		buf->dataLength = buf->bytesRead = 0;
+		buf->references = 1;					// assume it's only used once by default
+		buf->isReferenced = false;
+		buf->hadOverflow = false;
+		buf->whenQueued = millis();				// use the time of allocation as the default when-used time
+	}
+	return buf;
+}
 
-			return true;
-		}
+// Allocates an output buffer instance which can be used for (large) string outputs. This must be thread safe. Not safe to call from interrupts!
+// Most responses are short, so this allocates a normal size buffer if there is one. If the response turns out to be long, large buffers are used to extend it.
+// If there are no normal buffers left, use a large one rather than fail.
+/*static*/ bool OutputBuffer::Allocate(OutputBuffer *&buf) noexcept
+{
+	buf = AllocateFrom(NormalBuffer);
+	if (buf == nullptr)
+	{
+		buf = AllocateFrom(LargeBuffer);
+	}
+	if (buf != nullptr)
+	{
+		return true;
 	}
 
 	reprap.GetPlatform().LogError(ErrorCode::OutputStarvation);
 	return false;
 }
 
+// Allocate a buffer to extend a chain whose last buffer is full.
+// The response is already longer than a normal buffer, so use a large buffer if there is one free. This means it takes fewer sends to transmit it.
+/*static*/ OutputBuffer *OutputBuffer::AllocateToExtend() noexcept
+{
+	OutputBuffer *buf = AllocateFrom(LargeBuffer);
+	if (buf == nullptr)
+	{
+		buf = AllocateFrom(NormalBuffer);
+		if (buf == nullptr)
+		{
+			reprap.GetPlatform().LogError(ErrorCode::OutputStarvation);
+		}
+	}
+	return buf;
+}
+
 // Get the number of bytes left for continuous writing
 /*static*/ size_t OutputBuffer::GetBytesLeft(const OutputBuffer *writingBuffer) noexcept
 {
-	const size_t freeOutputBuffers = OUTPUT_BUFFER_COUNT - usedOutputBuffers;
-	const size_t bytesLeft = OUTPUT_BUFFER_SIZE - writingBuffer->last->DataLength();
+	const size_t freeNormalBuffers = OUTPUT_BUFFER_COUNT - usedOutputBuffers[NormalBuffer];
+	const size_t freeLargeBuffers = LARGE_OUTPUT_BUFFER_COUNT - usedOutputBuffers[LargeBuffer];
 
-	if (freeOutputBuffers < RESERVED_OUTPUT_BUFFERS)
-	{
-		// Keep some space left to encapsulate the responses (e.g. via an HTTP header)
-		return bytesLeft;
-	}
+	// Keep some buffers left to encapsulate the responses (e.g. via an HTTP header). Allocate takes normal buffers first and then large ones, so reserve them in that order.
+	const size_t reservedNormalBuffers = min<size_t>(freeNormalBuffers, RESERVED_OUTPUT_BUFFERS);
+	const size_t reservedLargeBuffers = min<size_t>(freeLargeBuffers, RESERVED_OUTPUT_BUFFERS - reservedNormalBuffers);
 
-	return bytesLeft + (freeOutputBuffers - RESERVED_OUTPUT_BUFFERS) * OUTPUT_BUFFER_SIZE;
+	return writingBuffer->last->capacity - writingBuffer->last->DataLength()
+			+ (freeNormalBuffers - reservedNormalBuffers) * OUTPUT_BUFFER_SIZE
+			+ (freeLargeBuffers - reservedLargeBuffers) * LARGE_OUTPUT_BUFFER_SIZE;
 }
 
 // Truncate an output buffer to free up more memory. Returns the number of released bytes.
@@ -448,8 +539,8 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 		}
 
 		// Unlink and free the last entry
+		releasedBytes += lastItem->capacity;
 		ReleaseAll(previousItem->next);
-		releasedBytes += OUTPUT_BUFFER_SIZE;
 	} while (previousItem != buffer && releasedBytes < bytesNeeded);
 
 	// Update all the references to the last item
@@ -474,10 +565,10 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 	}
 	else
 	{
-		// Otherwise prepend it to the list of free output buffers again
-		buf->next = freeOutputBuffers;
-		freeOutputBuffers = buf;
-		usedOutputBuffers--;
+		// Otherwise prepend it to the list of free output buffers of its size class again
+		buf->next = freeOutputBuffers[buf->sizeClass];
+		freeOutputBuffers[buf->sizeClass] = buf;
+		usedOutputBuffers[buf->sizeClass]--;
 	}
 	return nextBuffer;
 }
@@ -492,8 +583,9 @@ bool OutputBuffer::WriteToFile(FileData& f) const noexcept
 
 /*static*/ void OutputBuffer::Diagnostics(MessageType mtype) noexcept
 {
-	reprap.GetPlatform().MessageF(mtype, "Used output buffers: %d of %d (%d max)\n",
-			usedOutputBuffers, OUTPUT_BUFFER_COUNT, maxUsedOutputBuffers);
+	reprap.GetPlatform().MessageF(mtype, "Used output buffers: %d of %d (%d max), large: %d of %d (%d max)\n",
+			usedOutputBuffers[NormalBuffer], OUTPUT_BUFFER_COUNT, maxUsedOutputBuffers[NormalBuffer],
+			usedOutputBuffers[LargeBuffer], LARGE_OUTPUT_BUFFER_COUNT, maxUsedOutputBuffers[LargeBuffer]);
 }
 
 //*************************************************************************************************
@@ -511,8 +603,9 @@ bool OutputStack::Push(OutputBuffer *buffer, MessageType type) volatile noexcept
 			{
 				buffer->whenQueued = millis();
 			}
-			items[count] = buffer;
-			types[count] = type;
+			const size_t index = IndexOf(count);
+			items[index] = buffer;
+			types[index] = type;
 			count++;
 			return true;
 		}
@@ -532,12 +625,8 @@ OutputBuffer *OutputStack::Pop() volatile noexcept
 		return nullptr;
 	}
 
-	OutputBuffer *item = items[0];
-	for (size_t i = 1; i < count; i++)
-	{
-		items[i - 1] = items[i];
-		types[i - 1] = types[i];
-	}
+	OutputBuffer *item = items[first];
+	first = IndexOf(1);
 	count--;
 
 	return item;
@@ -546,13 +635,13 @@ OutputBuffer *OutputStack::Pop() volatile noexcept
 // Returns the first item from the stack or nullptr if none is available
 OutputBuffer *OutputStack::GetFirstItem() const volatile noexcept
 {
-	return (count == 0) ? nullptr : items[0];
+	return (count == 0) ? nullptr : items[first];
 }
 
 // Returns the first item's type from the stack or NoDestinationMessage if none is available
 MessageType OutputStack::GetFirstItemType() const volatile noexcept
 {
-	return (count == 0) ? MessageType::NoDestinationMessage : types[0];
+	return (count == 0) ? MessageType::NoDestinationMessage : types[first];
 }
 
 #if HAS_LINUX_INTERFACE
@@ -568,7 +657,7 @@ void OutputStack::SetFirstItem(OutputBuffer *buffer) volatile noexcept
 		}
 		else
 		{
-			items[0] = buffer;
+			items[first] = buffer;
 			buffer->whenQueued = millis();
 		}
 	}
@@ -581,12 +670,13 @@ void OutputStack::ReleaseFirstItem() volatile noexcept
 {
 	if (count != 0)
 	{
-		OutputBuffer * const buf = items[0];					// capture volatile variable
+		const size_t index = first;							// capture volatile variable
+		OutputBuffer * const buf = items[index];			// capture volatile variable
 		if (buf != nullptr)
 		{
-			items[0] = OutputBuffer::Release(buf);
+			items[index] = OutputBuffer::Release(buf);
 		}
-		if (items[0] == nullptr)
+		if (items[index] == nullptr)
 		{
 			(void)Pop();
 		}
@@ -599,13 +689,14 @@ bool OutputStack::ApplyTimeout(uint32_t ticks) volatile noexcept
 	bool ret = false;
 	if (count != 0)
 	{
-		OutputBuffer * buf = items[0];							// capture volatile variable
+		const size_t index = first;							// capture volatile variable
+		OutputBuffer * buf = items[index];					// capture volatile variable
 		while (buf != nullptr && millis() - buf->whenQueued >= ticks)
 		{
-			items[0] = buf = OutputBuffer::Release(buf);
+			items[index] = buf = OutputBuffer::Release(buf);
 			ret = true;
 		}
-		if (items[0] == nullptr)
+		if (items[index] == nullptr)
 		{
 			(void)Pop();
 			ret = true;
@@ -617,13 +708,13 @@ bool OutputStack::ApplyTimeout(uint32_t ticks) volatile noexcept
 // Returns the last item from the stack or nullptr if none is available
 OutputBuffer *OutputStack::GetLastItem() const volatile noexcept
 {
-	return (count == 0) ? nullptr : items[count - 1];
+	return (count == 0) ? nullptr : items[IndexOf(count - 1)];
 }
 
 // Returns the type of the last item from the stack or NoDestinationMessage if none is available
 MessageType OutputStack::GetLastItemType() const volatile noexcept
 {
-	return (count == 0) ? MessageType::NoDestinationMessage : types[count - 1];
+	return (count == 0) ? MessageType::NoDestinationMessage : types[IndexOf(count - 1)];
 }
 
 // Get the total length of all queued buffers
@@ -634,9 +725,10 @@ size_t OutputStack::DataLength() const volatile noexcept
 	TaskCriticalSectionLocker lock;
 	for (size_t i = 0; i < count; i++)
 	{
-		if (items[i] != nullptr)
+		const OutputBuffer * const buf = items[IndexOf(i)];
+		if (buf != nullptr)
 		{
-			totalLength += items[i]->Length();
+			totalLength += buf->Length();
 		}
 	}
 
@@ -649,16 +741,18 @@ void OutputStack::Append(volatile OutputStack& stack) volatile noexcept
 {
 	for (size_t i = 0; i < stack.count; i++)
 	{
+		const size_t sourceIndex = stack.IndexOf(i);
 		if (count < OUTPUT_STACK_DEPTH)
 		{
-			items[count] = stack.items[i];
-			types[count] = stack.types[i];
+			const size_t index = IndexOf(count);
+			items[index] = stack.items[sourceIndex];
+			types[index] = stack.types[sourceIndex];
 			count++;
 		}
 		else
 		{
 			reprap.GetPlatform().LogError(ErrorCode::OutputStackOverflow);
-			OutputBuffer::ReleaseAll(stack.items[i]);
+			OutputBuffer::ReleaseAll(stack.items[sourceIndex]);
 		}
 	}
 }
@@ -669,9 +763,10 @@ void OutputStack::IncreaseReferences(size_t num) volatile noexcept
 	TaskCriticalSectionLocker lock;
 	for (size_t i = 0; i < count; i++)
 	{
-		if (items[i] != nullptr)
+		OutputBuffer * const buf = items[IndexOf(i)];
+		if (buf != nullptr)
 		{
-			items[i]->IncreaseReferences(num);
+			buf->IncreaseReferences(num);
 		}
 	}
 }
@@ -681,7 +776,7 @@ void OutputStack::ReleaseAll() volatile noexcept
 {
 	for (size_t i = 0; i < count; i++)
 	{
-		OutputBuffer::ReleaseAll(items[i]);
+		OutputBuffer::ReleaseAll(items[IndexOf(i)]);
 	}
 	count = 0;
 }
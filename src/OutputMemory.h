@@ -26,7 +26,7 @@ class OutputBuffer
 public:
 	friend class OutputStack;
 
-	OutputBuffer(OutputBuffer *n) noexcept : next(n) { }
+	OutputBuffer(OutputBuffer *n, char *storage, size_t cap, uint8_t sc) noexcept : next(n), data(storage), capacity(cap), sizeClass(sc) { }
 	OutputBuffer(const OutputBuffer&) = delete;
 
 	void Append(OutputBuffer *other) noexcept;
@@ -72,6 +72,16 @@ public:
 
 	size_t EncodeReply(OutputBuffer *src) noexcept;
 
+	// CBOR (RFC 8949) encoding, used for binary object model reports
+	static constexpr uint8_t CborUnsignedInt = 0, CborNegativeInt = 1, CborTextString = 3, CborArray = 4, CborMap = 5;		// major types
+	static constexpr char CborFalse = '\xF4', CborTrue = '\xF5', CborNull = '\xF6', CborEmptyMap = '\xA0';
+	static constexpr char CborStartMap = '\xBF', CborBreak = '\xFF';											// start and end of a map of unknown length
+
+	size_t CborHead(uint8_t majorType, uint64_t val) noexcept;				// append the head of a data item, i.e. its type and value or length
+	size_t CborSigned(int32_t val) noexcept;
+	size_t CborFloat(float val) noexcept;
+	size_t CborString(const char *src, bool allowControlChars) noexcept;
+
 	uint32_t GetAge() const noexcept;
 
 #if HAS_MASS_STORAGE
@@ -99,24 +109,35 @@ public:
 
 	static void Diagnostics(MessageType mtype) noexcept;
 
-	static unsigned int GetFreeBuffers() { return OUTPUT_BUFFER_COUNT - usedOutputBuffers; }
+	static unsigned int GetFreeBuffers() { return (OUTPUT_BUFFER_COUNT - usedOutputBuffers[NormalBuffer]) + (LARGE_OUTPUT_BUFFER_COUNT - usedOutputBuffers[LargeBuffer]); }
 
 private:
+	// Size classes
+	static constexpr uint8_t NormalBuffer = 0, LargeBuffer = 1, NumSizeClasses = 2;
+
+	// Allocate a buffer of the specified size class without reporting an error if there are none left
+	static OutputBuffer *AllocateFrom(uint8_t sc) noexcept;
+
+	// Allocate a buffer to extend a chain that has filled its last buffer, preferring a large one
+	static OutputBuffer *AllocateToExtend() noexcept;
+
 	OutputBuffer *next;
 	OutputBuffer *last;
 
 	uint32_t whenQueued;
 
-	char data[OUTPUT_BUFFER_SIZE];
+	char * const data;
+	const size_t capacity;
 	size_t dataLength, bytesRead;
 
+	const uint8_t sizeClass;
 	bool isReferenced;
 	bool hadOverflow;
 	volatile size_t references;
 
-	static OutputBuffer * volatile freeOutputBuffers;		// Messages may be sent by multiple tasks
-	static volatile size_t usedOutputBuffers;				// so make these volatile.
-	static volatile size_t maxUsedOutputBuffers;
+	static OutputBuffer * volatile freeOutputBuffers[NumSizeClasses];	// Messages may be sent by multiple tasks
+	static volatile size_t usedOutputBuffers[NumSizeClasses];			// so make these volatile.
+	static volatile size_t maxUsedOutputBuffers[NumSizeClasses];
 };
 
 inline uint32_t OutputBuffer::GetAge() const noexcept
@@ -129,7 +150,7 @@ inline uint32_t OutputBuffer::GetAge() const noexcept
 class OutputStack
 {
 public:
-	OutputStack() noexcept : count(0) { }
+	OutputStack() noexcept : first(0), count(0) { }
 	OutputStack(const OutputStack&) = delete;
 
 	// Is there anything on this stack?
@@ -180,9 +201,19 @@ public:
 	void ReleaseAll() volatile noexcept;
 
 private:
+	// The items are held in a circular buffer so that pushing and popping take constant time, which keeps the critical sections short
+	size_t IndexOf(size_t n) const volatile noexcept;		// return the index in the arrays of the nth item from the top of the stack
+
+	size_t first;											// index of the first item
 	size_t count;
 	OutputBuffer * items[OUTPUT_STACK_DEPTH];
 	MessageType types[OUTPUT_STACK_DEPTH];
 };
 
+inline size_t OutputStack::IndexOf(size_t n) const volatile noexcept
+{
+	const size_t i = first + n;
+	return (i < OUTPUT_STACK_DEPTH) ? i : i - OUTPUT_STACK_DEPTH;
+}
+
 #endif /* OUTPUTMEMORY_H_ */
@@ -164,6 +164,10 @@
 # define HAS_MASS_STORAGE		1
 #endif
 
+#ifndef SUPPORT_TOKENIZED_GCODE
+# define SUPPORT_TOKENIZED_GCODE	(HAS_MASS_STORAGE && HAS_LINUX_INTERFACE)	// tokenized moves are executed by the binary parser. Other builds refuse tokenized files.
+#endif
+
 #ifndef SUPPORT_ASYNC_MOVES
 # define SUPPORT_ASYNC_MOVES	0
 #endif
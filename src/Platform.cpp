@@ -2235,6 +2235,15 @@ GCodeResult Platform::DiagnosticTest(GCodeBuffer& gb, const StringRef& reply, Ou
 				);
 		break;
 
+	case (unsigned int)DiagnosticTestType::PrintMoveTiming:
+		if (!OutputBuffer::Allocate(buf))
+		{
+			reply.copy("No output buffer");
+			return GCodeResult::error;
+		}
+		reprap.GetMove().AppendTimingAsJson(buf);
+		break;
+
 #ifdef DUET_NG
 	case (unsigned int)DiagnosticTestType::PrintExpanderStatus:
 		reply.printf("Expander status %04X\n", DuetExpansion::DiagnosticRead());
@@ -3878,10 +3887,18 @@ void Platform::AppendSysDir(const StringRef & path) const noexcept
 	path.cat(InternalGetSysDir());
 }
 
-void Platform::EncodeSysDir(OutputBuffer *buf) const noexcept
+// Append the system directory to the buffer as a JSON or CBOR string
+void Platform::EncodeSysDir(OutputBuffer *buf, bool binary) const noexcept
 {
 	MutexLocker lock(Tasks::GetSysDirMutex());
-	buf->EncodeString(InternalGetSysDir(), false);
+	if (binary)
+	{
+		buf->CborString(InternalGetSysDir(), false);
+	}
+	else
+	{
+		buf->EncodeString(InternalGetSysDir(), false);
+	}
 }
 
 #endif
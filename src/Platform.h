@@ -158,6 +158,7 @@ enum class DiagnosticTestType : unsigned int
 	TimeSDWrite = 104,				// do a write timing test on the SD card
 	PrintObjectSizes = 105,			// print the sizes of various objects
 	PrintObjectAddresses = 106,		// print the addresses and sizes of various objects
+	PrintMoveTiming = 107,			// print the step generation and move preparation timing statistics as JSON, then reset them
 
 #ifdef __LPC17xx__
     PrintBoardConfiguration = 200,    //Prints out all pin/values loaded from SDCard to configure board
@@ -365,7 +366,7 @@ public:
 	bool DeleteSysFile(const char *filename) const noexcept;
 	bool MakeSysFileName(const StringRef& result, const char *filename) const noexcept;
 	void AppendSysDir(const StringRef & path) const noexcept;
-	void EncodeSysDir(OutputBuffer *buf) const noexcept;
+	void EncodeSysDir(OutputBuffer *buf, bool binary) const noexcept;
 #endif
 
 	// Message output (see MessageType for further details)
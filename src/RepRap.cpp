@@ -366,6 +366,45 @@ constexpr uint8_t RepRap::objectModelTableDescriptor[] =
 
 DEFINE_GET_OBJECT_MODEL_TABLE(RepRap)
 
+// Return true if the value of an entry in the object model may have changed since the specified sequence number.
+// We only keep sequence numbers for the entries in the root table that have them in 'seqs', so we must assume that any other entry has changed.
+bool RepRap::HasChangedSince(const ObjectModelTableEntry *entry, uint32_t seq) const noexcept
+{
+	static const struct
+	{
+		const char *name;
+		uint32_t RepRap::*entrySeq;
+	} entrySeqs[] =
+	{
+		{ "boards",			&RepRap::boardsSeq },
+		{ "directories",	&RepRap::directoriesSeq },
+		{ "fans",			&RepRap::fansSeq },
+		{ "heat",			&RepRap::heatSeq },
+		{ "inputs",			&RepRap::inputsSeq },
+		{ "job",			&RepRap::jobSeq },
+		{ "move",			&RepRap::moveSeq },
+		{ "network",		&RepRap::networkSeq },
+		{ "scanner",		&RepRap::scannerSeq },
+		{ "sensors",		&RepRap::sensorsSeq },
+		{ "spindles",		&RepRap::spindlesSeq },
+		{ "state",			&RepRap::stateSeq },
+		{ "tools",			&RepRap::toolsSeq },
+		{ "volumes",		&RepRap::volumesSeq },
+	};
+
+	if (entry >= objectModelTable && entry < objectModelTable + objectModelTableDescriptor[1])
+	{
+		for (const auto& es : entrySeqs)
+		{
+			if (strcmp(entry->GetName(), es.name) == 0)
+			{
+				return this->*es.entrySeq > seq;
+			}
+		}
+	}
+	return true;
+}
+
 #endif
 
 ReadWriteLock RepRap::toolListLock;
@@ -375,7 +414,7 @@ ReadWriteLock RepRap::toolListLock;
 // Do nothing more in the constructor; put what you want in RepRap:Init()
 
 RepRap::RepRap() noexcept
-	: boardsSeq(0), directoriesSeq(0), fansSeq(0), heatSeq(0), inputsSeq(0), jobSeq(0), moveSeq(0),
+	: modelSeq(0), boardsSeq(0), directoriesSeq(0), fansSeq(0), heatSeq(0), inputsSeq(0), jobSeq(0), moveSeq(0),
 	  networkSeq(0), scannerSeq(0), sensorsSeq(0), spindlesSeq(0), stateSeq(0), toolsSeq(0), volumesSeq(0),
 	  toolList(nullptr), currentTool(nullptr), lastWarningMillis(0),
 	  activeExtruders(0), activeToolHeaters(0), numToolsToReport(0),
@@ -423,6 +462,15 @@ RepRap::RepRap() noexcept
 #endif
 }
 
+// Give a part of the object model a new sequence number because it has changed.
+// The increment and the store must not be interrupted by another task doing the same, otherwise two entries could get the same number,
+// or an entry could get a number that is not greater than one we have already reported to a client, so the client would never see the change.
+void RepRap::StampChange(uint32_t& entrySeq) noexcept
+{
+	TaskCriticalSectionLocker lock;
+	entrySeq = ++modelSeq;
+}
+
 void RepRap::Init() noexcept
 {
 	messageBoxMutex.Create("MessageBox");
@@ -1873,7 +1921,7 @@ OutputBuffer *RepRap::GetConfigResponse() noexcept
 #if HAS_MASS_STORAGE
 	// System files folder
 	response->catf(", \"sysdir\":");
-	platform->EncodeSysDir(response);
+	platform->EncodeSysDir(response, false);
 #endif
 
 	// Motor idle parameters
@@ -2389,10 +2437,7 @@ OutputBuffer *RepRap::GetModelResponse(const char *key, const char *flags) const
 		if (key == nullptr) { key = ""; }
 		if (flags == nullptr) { flags = ""; }
 
-		outBuf->printf("{\"key\":");
-		outBuf->EncodeString(key, false);
-		outBuf->catf(",\"flags\":");
-		outBuf->EncodeString(flags, false);
+		ReportModelResponseHeader(outBuf, key, flags);
 
 		const bool wantArrayLength = (*key == '#');
 		if (wantArrayLength)
@@ -2400,14 +2445,42 @@ OutputBuffer *RepRap::GetModelResponse(const char *key, const char *flags) const
 			++key;
 		}
 
-		outBuf->cat(",\"result\":");
 		reprap.ReportAsJson(outBuf, key, flags, wantArrayLength);
-		outBuf->cat('}');
+		if (!IsBinaryReport(flags))
+		{
+			outBuf->cat('}');
+		}
 	}
 
 	return outBuf;
 }
 
+// Put the start of a response to an object model query in the buffer, up to the point where the result goes.
+// In CBOR the response is a map with a fixed number of entries, so it doesn't need a terminator after the result.
+void RepRap::ReportModelResponseHeader(OutputBuffer *buf, const char *key, const char *flags) const noexcept
+{
+	if (IsBinaryReport(flags))
+	{
+		buf->copy("");
+		buf->CborHead(OutputBuffer::CborMap, 4);
+		buf->CborString("key", false);
+		buf->CborString(key, false);
+		buf->CborString("flags", false);
+		buf->CborString(flags, false);
+		buf->CborString("seq", false);
+		buf->CborHead(OutputBuffer::CborUnsignedInt, modelSeq);
+		buf->CborString("result", false);
+		return;
+	}
+
+	buf->printf("{\"key\":");
+	buf->EncodeString(key, false);
+	buf->catf(",\"flags\":");
+	buf->EncodeString(flags, false);
+	buf->catf(",\"seq\":%" PRIu32, modelSeq);							// the client can pass this in the 'c' flag of a later query to get just the changes since this one
+	buf->cat(",\"result\":");
+}
+
 #endif
 
 // Send a beep. We send it to both PanelDue and the web interface.
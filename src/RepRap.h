@@ -153,6 +153,7 @@ public:
 
 #if SUPPORT_OBJECT_MODEL
 	OutputBuffer *GetModelResponse(const char *key, const char *flags) const THROWS(GCodeException);
+	void ReportModelResponseHeader(OutputBuffer *buf, const char *key, const char *flags) const noexcept;
 #endif
 
 	void Beep(unsigned int freq, unsigned int ms) noexcept;
@@ -182,23 +183,28 @@ public:
 
 	void KickHeatTaskWatchdog() noexcept { heatTaskIdleTicks = 0; }
 
-	void BoardsUpdated() noexcept { ++boardsSeq; }
-	void DirectoriesUpdated() noexcept { ++directoriesSeq; }
-	void FansUpdated() noexcept { ++fansSeq; }
-	void HeatUpdated() noexcept { ++heatSeq; }
-	void InputsUpdated() noexcept { ++inputsSeq; }
-	void JobUpdated() noexcept { ++jobSeq; }
-	void MoveUpdated() noexcept { ++moveSeq; }
-	void NetworkUpdated() noexcept { ++networkSeq; }
-	void ScannerUpdated() noexcept { ++scannerSeq; }
-	void SensorsUpdated() noexcept { ++sensorsSeq; }
-	void SpindlesUpdated() noexcept { ++spindlesSeq; }
-	void StateUpdated() noexcept { ++stateSeq; }
-	void ToolsUpdated() noexcept { ++toolsSeq; }
-	void VolumesUpdated() noexcept { ++volumesSeq; }
+	// Each time part of the object model changes we give it a new sequence number from modelSeq, so that clients can ask for just the parts that changed since an earlier query.
+	// These are called from several tasks, so StampChange makes sure that each number is unique and greater than any that a client has already been sent.
+	void BoardsUpdated() noexcept { StampChange(boardsSeq); }
+	void DirectoriesUpdated() noexcept { StampChange(directoriesSeq); }
+	void FansUpdated() noexcept { StampChange(fansSeq); }
+	void HeatUpdated() noexcept { StampChange(heatSeq); }
+	void InputsUpdated() noexcept { StampChange(inputsSeq); }
+	void JobUpdated() noexcept { StampChange(jobSeq); }
+	void MoveUpdated() noexcept { StampChange(moveSeq); }
+	void NetworkUpdated() noexcept { StampChange(networkSeq); }
+	void ScannerUpdated() noexcept { StampChange(scannerSeq); }
+	void SensorsUpdated() noexcept { StampChange(sensorsSeq); }
+	void SpindlesUpdated() noexcept { StampChange(spindlesSeq); }
+	void StateUpdated() noexcept { StampChange(stateSeq); }
+	void ToolsUpdated() noexcept { StampChange(toolsSeq); }
+	void VolumesUpdated() noexcept { StampChange(volumesSeq); }
 
 protected:
 	DECLARE_OBJECT_MODEL
+#if SUPPORT_OBJECT_MODEL
+	bool HasChangedSince(const ObjectModelTableEntry *entry, uint32_t seq) const noexcept override;
+#endif
 	OBJECT_MODEL_ARRAY(boards)
 	OBJECT_MODEL_ARRAY(fans)
 	OBJECT_MODEL_ARRAY(gpout)
@@ -256,8 +262,11 @@ private:
 
  	Mutex messageBoxMutex;
 
-	uint16_t boardsSeq, directoriesSeq, fansSeq, heatSeq, inputsSeq, jobSeq, moveSeq;
-	uint16_t networkSeq, scannerSeq, sensorsSeq, spindlesSeq, stateSeq, toolsSeq, volumesSeq;
+	uint32_t modelSeq;							// the sequence number that we last gave to a change in the object model
+	uint32_t boardsSeq, directoriesSeq, fansSeq, heatSeq, inputsSeq, jobSeq, moveSeq;
+	uint32_t networkSeq, scannerSeq, sensorsSeq, spindlesSeq, stateSeq, toolsSeq, volumesSeq;
+
+	void StampChange(uint32_t& entrySeq) noexcept;
 
 	Tool* toolList;								// the tool list is sorted in order of increasing tool number
 	Tool* currentTool;
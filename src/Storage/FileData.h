@@ -21,11 +21,12 @@ class FileData
 public:
 	friend class FileGCodeInput;
 
-	FileData() noexcept : f(nullptr) {}
+	FileData() noexcept : f(nullptr), format(Format::unknown) {}
 
 	FileData(const FileData& other) noexcept
 	{
 		f = other.f;
+		format = other.format;
 		if (f != nullptr)
 		{
 			f->Duplicate();
@@ -37,6 +38,7 @@ public:
 	{
 		Close();	// close any existing file
 		f = pfile;
+		format = Format::unknown;
 	}
 
 	bool IsLive() const noexcept { return f != nullptr; }
@@ -46,7 +48,7 @@ public:
 		if (f != nullptr)
 		{
 			bool ok = f->Close();
-			f = nullptr;
+			Init();
 			return ok;
 		}
 		return false;
@@ -113,15 +115,21 @@ public:
 	{
 		Close();
 		f = other.f;
+		format = other.format;
 		other.Init();
 	}
 
 private:
+	// The format of a G-code file, which FileGCodeInput checks the first time it reads the file so that it doesn't need to read the header again after each macro returns
+	enum class Format : uint8_t { unknown = 0, text, tokenized };
+
 	FileStore *f;
+	Format format;
 
 	void Init() noexcept
 	{
 		f = nullptr;
+		format = Format::unknown;
 	}
 
 	// Private assignment operator to prevent us assigning these objects
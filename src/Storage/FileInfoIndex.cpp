@@ -0,0 +1,164 @@
+/*
+ * FileInfoIndex.cpp
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include "FileInfoIndex.h"
+
+#if HAS_MASS_STORAGE
+
+#include "MassStorage.h"
+#include "CRC32.h"
+
+// Return the hash of a file path. FAT filenames are not case sensitive, so neither is the hash.
+/*static*/ uint32_t FileInfoIndex::HashPath(const char *filePath) noexcept
+{
+	CRC32 crc;
+	while (*filePath != 0)
+	{
+		crc.Update((char)tolower(*filePath++));
+	}
+	return crc.Get();
+}
+
+// Read the path hashes, file sizes and dates from the index file. If there is no valid index file then we start with an empty index.
+void FileInfoIndex::Load() noexcept
+{
+	numEntries = nextEntryToReplace = 0;
+	loaded = true;
+
+	FileStore * const f = MassStorage::OpenFile(FILE_INFO_INDEX_FILE, OpenMode::read, 0);
+	if (f != nullptr)
+	{
+		Header header;
+		if (   f->Read(reinterpret_cast<char*>(&header), sizeof(header)) == (int)sizeof(header)
+			&& header.magic == IndexMagic && header.entrySize == sizeof(Entry)
+		   )
+		{
+			Entry entry;
+			while (numEntries < MaxFileInfoIndexEntries && f->Read(reinterpret_cast<char*>(&entry), sizeof(entry)) == (int)sizeof(entry))
+			{
+				summaries[numEntries++].Set(entry.pathHash, entry.info.fileSize, entry.info.lastModifiedTime);
+			}
+		}
+		f->Close();
+	}
+}
+
+bool FileInfoIndex::ReadEntry(size_t index, Entry& entry) const noexcept
+{
+	FileStore * const f = MassStorage::OpenFile(FILE_INFO_INDEX_FILE, OpenMode::read, 0);
+	if (f == nullptr)
+	{
+		return false;
+	}
+	const bool ok = f->Seek(sizeof(Header) + index * sizeof(Entry)) && f->Read(reinterpret_cast<char*>(&entry), sizeof(entry)) == (int)sizeof(entry);
+	f->Close();
+	return ok;
+}
+
+// Return the index of the entry for the file with the specified path hash, or -1 if there is none
+int FileInfoIndex::FindSlot(uint32_t hash) noexcept
+{
+	if (!loaded)
+	{
+		Load();
+	}
+
+	for (size_t i = 0; i < numEntries; ++i)
+	{
+		if (summaries[i].pathHash == hash)
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+// Return true if we have information for the file and the file hasn't changed since. This doesn't read the index file, except to load it the first time.
+bool FileInfoIndex::IsUpToDate(const char *filePath, FilePosition fileSize, time_t lastModifiedTime) noexcept
+{
+	const int slot = FindSlot(HashPath(filePath));
+	return slot >= 0 && summaries[slot].Matches(fileSize, lastModifiedTime);
+}
+
+// Look up a file. If we have information for it and the file hasn't changed since, copy the information to 'info' and return true.
+bool FileInfoIndex::Find(const char *filePath, FilePosition fileSize, time_t lastModifiedTime, GCodeFileInfo& info) noexcept
+{
+	const uint32_t hash = HashPath(filePath);
+	const int slot = FindSlot(hash);
+	if (slot < 0 || !summaries[slot].Matches(fileSize, lastModifiedTime))
+	{
+		return false;
+	}
+
+	// The index file may have been replaced or changed since we loaded it, so check the entry too
+	Entry entry;
+	if (   ReadEntry(slot, entry)
+		&& entry.pathHash == hash && entry.info.fileSize == fileSize && entry.info.lastModifiedTime == lastModifiedTime
+	   )
+	{
+		info = entry.info;
+		return true;
+	}
+	return false;
+}
+
+// Add or update the information for a file. If the index is full, replace the entries in rotation.
+void FileInfoIndex::Store(const char *filePath, const GCodeFileInfo& info) noexcept
+{
+	const uint32_t hash = HashPath(filePath);
+	const int foundSlot = FindSlot(hash);
+	size_t slot = (foundSlot >= 0) ? (size_t)foundSlot : numEntries;
+	if (slot == MaxFileInfoIndexEntries)
+	{
+		slot = nextEntryToReplace;
+		nextEntryToReplace = (nextEntryToReplace + 1) % MaxFileInfoIndexEntries;
+	}
+
+	// If the index is empty then create a new index file, which replaces any index file that had the wrong format.
+	// Otherwise update the existing file in place.
+	FileStore * const f = MassStorage::OpenFile(FILE_INFO_INDEX_FILE, (numEntries == 0) ? OpenMode::write : OpenMode::append, 0);
+	if (f == nullptr)
+	{
+		return;
+	}
+
+	bool ok;
+	if (numEntries == 0)
+	{
+		const Header header = { IndexMagic, sizeof(Entry) };
+		ok = f->Write(reinterpret_cast<const char*>(&header), sizeof(header));
+	}
+	else
+	{
+		ok = f->Seek(sizeof(Header) + slot * sizeof(Entry));
+	}
+
+	if (ok)
+	{
+		Entry entry;
+		entry.pathHash = hash;
+		entry.info = info;
+		ok = f->Write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+	}
+	ok = f->Close() && ok;
+
+	if (ok)
+	{
+		summaries[slot].Set(hash, info.fileSize, info.lastModifiedTime);
+		if (slot == numEntries)
+		{
+			++numEntries;
+		}
+	}
+	else
+	{
+		loaded = false;						// read the index again before we next use it
+	}
+}
+
+#endif
+
+// End
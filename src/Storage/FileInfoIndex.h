@@ -0,0 +1,70 @@
+/*
+ * FileInfoIndex.h
+ *
+ *  Created on: 17 Oct 2026
+ *
+ *  This class keeps the information that FileInfoParser finds in G-code files in an index file on the SD card, so that each file only needs to be parsed once.
+ *  Entries are keyed by a CRC of the file path and are only used if the file size and last modified time still match.
+ *  We keep the path CRCs in RAM along with the file sizes and dates, so that we can tell whether a file needs parsing without reading the card,
+ *  and a lookup reads at most one entry from the card.
+ *  We also store empty files and files that are not G-code files, so that the background scan doesn't open them again.
+ */
+
+#ifndef SRC_STORAGE_FILEINFOINDEX_H_
+#define SRC_STORAGE_FILEINFOINDEX_H_
+
+#include "RepRapFirmware.h"
+#include "GCodes/GCodeFileInfo.h"
+
+#if HAS_MASS_STORAGE
+
+class FileInfoIndex
+{
+public:
+	FileInfoIndex() noexcept : numEntries(0), nextEntryToReplace(0), loaded(false) { }
+
+	bool Find(const char *filePath, FilePosition fileSize, time_t lastModifiedTime, GCodeFileInfo& info) noexcept;	// look up a file, returning true if we have up-to-date information for it
+	bool IsUpToDate(const char *filePath, FilePosition fileSize, time_t lastModifiedTime) noexcept;				// return true if we have up-to-date information for a file, without reading the index file
+	void Store(const char *filePath, const GCodeFileInfo& info) noexcept;		// add or update the information for a file
+	void Invalidate() noexcept { loaded = false; }							// called when the SD card is unmounted, so that we read the index again
+
+private:
+	static constexpr uint32_t IndexMagic = 0x49494652;		// "RFII"
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t entrySize;									// so that we discard the index if the layout of GCodeFileInfo changes
+	};
+
+	struct Entry
+	{
+		uint32_t pathHash;
+		GCodeFileInfo info;
+	};
+
+	// The part of each entry that we keep in RAM. We only need to compare the time stamp, so we don't store it as a time_t.
+	struct Summary
+	{
+		uint32_t pathHash;
+		FilePosition fileSize;
+		uint32_t lastModifiedTime;
+
+		void Set(uint32_t hash, FilePosition size, time_t lastModified) noexcept { pathHash = hash; fileSize = size; lastModifiedTime = (uint32_t)lastModified; }
+		bool Matches(FilePosition size, time_t lastModified) const noexcept { return fileSize == size && lastModifiedTime == (uint32_t)lastModified; }
+	};
+
+	static uint32_t HashPath(const char *filePath) noexcept;
+	void Load() noexcept;
+	int FindSlot(uint32_t hash) noexcept;
+	bool ReadEntry(size_t index, Entry& entry) const noexcept;
+
+	Summary summaries[MaxFileInfoIndexEntries];
+	size_t numEntries;
+	size_t nextEntryToReplace;
+	bool loaded;
+};
+
+#endif
+
+#endif /* SRC_STORAGE_FILEINFOINDEX_H_ */
@@ -11,16 +11,76 @@
 #include "Platform.h"
 #include "PrintMonitor.h"
 #include "GCodes/GCodes.h"
+#include "Movement/StepTimer.h"
 
 #if HAS_MASS_STORAGE
 
 FileInfoParser::FileInfoParser() noexcept
-	: parseState(notParsing), fileBeingParsed(nullptr), accumulatedParseTime(0), accumulatedReadTime(0), accumulatedSeekTime(0), fileOverlapLength(0)
+	: job(&jobs[0]), lastIndexScanTime(0), indexDirOpen(false), indexScanComplete(false), indexInvalidated(false), maxCallMicros(0)
 {
-	parsedFileInfo.Init();
+	for (FileParseJob& j : jobs)
+	{
+		j.parseState = notParsing;
+		j.file = nullptr;
+		j.inBackground = false;
+	}
 	parserMutex.Create("FileInfoParser");
 }
 
+// Return how far we have got with parsing this file, as a percentage
+unsigned int FileParseJob::GetProgress() const noexcept
+{
+	switch (parseState)
+	{
+	case parsingHeader:
+		return min<unsigned int>((file->Position() * 50u)/min<FilePosition>(max<FilePosition>(info.fileSize, 1), GCODE_HEADER_SIZE), 50);
+
+	case seeking:
+	case parsingFooter:
+		return 50 + min<unsigned int>(((info.fileSize - nextSeekPos) * 50u)/min<FilePosition>(max<FilePosition>(info.fileSize, 1), GCODE_FOOTER_SIZE), 49);
+
+	default:
+		return 0;
+	}
+}
+
+// Find the job that is parsing the specified file, or allocate a new one. Return nullptr if all the jobs are busy.
+FileParseJob *FileInfoParser::FindJob(const char *filePath) noexcept
+{
+	FileParseJob *freeJob = nullptr;
+	for (FileParseJob& j : jobs)
+	{
+		if (j.parseState == notParsing)
+		{
+			if (freeJob == nullptr)
+			{
+				freeJob = &j;
+			}
+		}
+		else if (StringEqualsIgnoreCase(filePath, j.fileName.c_str()))
+		{
+			return &j;
+		}
+	}
+	if (freeJob != nullptr)
+	{
+		return freeJob;
+	}
+
+	// All the jobs are busy. A client request takes priority over a file that we are parsing in the background,
+	// and we abandon a file if the client that asked for it has probably disconnected.
+	for (FileParseJob& j : jobs)
+	{
+		if (j.inBackground || millis() - j.lastParseTime >= MaxFileParseInterval)
+		{
+			j.file->Close();				// if it was a background job then we will come back to the file in the next scan
+			j.parseState = notParsing;
+			return &j;
+		}
+	}
+	return nullptr;
+}
+
 bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool quitEarly) noexcept
 {
 	MutexLocker lock(parserMutex, MAX_FILEINFO_PROCESS_TIME);
@@ -29,20 +89,189 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 		return false;
 	}
 
-	if (parseState != notParsing && !StringEqualsIgnoreCase(filePath, filenameBeingParsed.c_str()))
+	CheckInvalidated();
+	job = FindJob(filePath);
+	if (job == nullptr)
+	{
+		return false;						// try again later
+	}
+	job->inBackground = false;
+	const uint32_t startTicks = StepTimer::GetTimerTicks();
+	const bool done = DoGetFileInfo(filePath, info, quitEarly,
+										(reprap.GetPrintMonitor().IsPrinting()) ? MaxFileInfoMicrosWhenPrinting : MAX_FILEINFO_PROCESS_TIME * 1000);
+	const uint32_t callMicros = (uint32_t)(((uint64_t)(StepTimer::GetTimerTicks() - startTicks) * 1000000u)/StepTimer::StepClockRate);
+	if (callMicros > maxCallMicros)
+	{
+		maxCallMicros = callMicros;
+	}
+	return done;
+}
+
+// Return the percentage of the specified file that we have parsed, or -1 if we are not parsing it
+int FileInfoParser::GetProgress(const char *filePath) noexcept
+{
+	MutexLocker lock(parserMutex, MAX_FILEINFO_PROCESS_TIME);
+	if (lock)
+	{
+		for (const FileParseJob& j : jobs)
+		{
+			if (j.parseState != notParsing && StringEqualsIgnoreCase(filePath, j.fileName.c_str()))
+			{
+				return (int)j.GetProgress();
+			}
+		}
+	}
+	return -1;
+}
+
+void FileInfoParser::Diagnostics(MessageType mtype) noexcept
+{
+	MutexLocker lock(parserMutex, MAX_FILEINFO_PROCESS_TIME);
+	if (lock)
 	{
-		// We are already parsing a different file
-		if (millis() - lastFileParseTime < MaxFileParseInterval)
+		for (const FileParseJob& j : jobs)
 		{
-			return false;				// try again later
+			if (j.parseState != notParsing)
+			{
+				reprap.GetPlatform().MessageF(mtype, "Parsing %s%s, %u%% done\n", j.fileName.c_str(), (j.inBackground) ? " in background" : "", j.GetProgress());
+			}
 		}
+		reprap.GetPlatform().MessageF(mtype, "File info longest call %" PRIu32 "us\n", maxCallMicros);
+		maxCallMicros = 0;
+	}
+}
 
-		// Time this client out because it has probably disconnected
-		fileBeingParsed->Close();
-		parseState = notParsing;
+// Add the files in the G-code directory to the index, one parsing step per call. This is called from MassStorage::Spin, so we don't do it while printing.
+// We only parse one file at a time in the background, so that there is always a free job for a client request.
+void FileInfoParser::Spin() noexcept
+{
+	if (reprap.GetPrintMonitor().IsPrinting() || (indexScanComplete && millis() - lastIndexScanTime < FileInfoIndexScanInterval))
+	{
+		return;
 	}
 
-	if (parseState == notParsing)
+	MutexLocker lock(parserMutex, 0);
+	if (!lock)
+	{
+		return;
+	}
+
+	CheckInvalidated();
+
+	GCodeFileInfo info;
+	for (FileParseJob& j : jobs)
+	{
+		if (j.parseState != notParsing && j.inBackground)
+		{
+			job = &j;
+			(void)DoGetFileInfo(j.fileName.c_str(), info, false, 0);
+			return;
+		}
+	}
+
+	for (FileParseJob& j : jobs)
+	{
+		if (j.parseState == notParsing)
+		{
+			String<MaxFilenameLength> filePath;
+			if (FindFileToIndex(filePath.GetRef()))
+			{
+				job = &j;
+				job->inBackground = true;
+				(void)DoGetFileInfo(filePath.c_str(), info, false, 0);
+			}
+			return;
+		}
+	}
+}
+
+// Find the next file in the G-code directory that isn't in the index yet, returning false if there is none among the next few directory entries.
+// We keep the directory open between calls so that each scan reads the directory once, and we only look at a few entries per call so that Spin returns quickly.
+bool FileInfoParser::FindFileToIndex(const StringRef& filePath) noexcept
+{
+	const char * const dir = reprap.GetPlatform().GetGCodeDir();
+	if (!indexDirOpen)
+	{
+		indexDirOpen = MassStorage::OpenDirectory(indexDir, dir);
+		if (!indexDirOpen)
+		{
+			indexScanComplete = true;				// try again after the usual interval
+			lastIndexScanTime = millis();
+			return false;
+		}
+	}
+
+	FileInfo fileInfo;
+	for (unsigned int numExamined = 0; numExamined < MaxFilesExaminedPerSpin; ++numExamined)
+	{
+		if (!MassStorage::ReadDirectory(indexDir, fileInfo))
+		{
+			// We have looked at every file in the directory
+			indexDirOpen = false;
+			indexScanComplete = true;
+			lastIndexScanTime = millis();
+			return false;
+		}
+
+		if (   !fileInfo.isDirectory
+			&& MassStorage::CombineName(filePath, dir, fileInfo.fileName.c_str())
+			&& !index.IsUpToDate(filePath.c_str(), fileInfo.size, fileInfo.lastModified)
+		   )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Called when the SD card is unmounted. We can't take our mutex here, because the caller holds the file system mutex and we take them in the other order.
+// So we just set a flag, and the next call to GetFileInfo or Spin does the work.
+void FileInfoParser::InvalidateIndex() noexcept
+{
+	indexInvalidated = true;
+}
+
+// If the SD card has been unmounted since we last looked, abandon the files we were parsing and read the index again before we next use it.
+// The caller must hold the parser mutex.
+void FileInfoParser::CheckInvalidated() noexcept
+{
+	if (indexInvalidated)
+	{
+		indexInvalidated = false;
+		for (FileParseJob& j : jobs)
+		{
+			if (j.parseState != notParsing)
+			{
+				j.file->Close();
+				j.parseState = notParsing;
+			}
+			j.inBackground = false;
+		}
+		index.Invalidate();
+		indexScanComplete = false;
+		indexDirOpen = false;
+	}
+}
+
+// Return true if the file name has one of the extensions that we parse
+/*static*/ bool FileInfoParser::IsGCodeFileName(const char *filePath) noexcept
+{
+	return StringEndsWithIgnoreCase(filePath, ".gcode") || StringEndsWithIgnoreCase(filePath, ".g")
+		|| StringEndsWithIgnoreCase(filePath, ".gco") || StringEndsWithIgnoreCase(filePath, ".gc");
+}
+
+// Stop parsing a file that we can't read. We don't store it in the index, because the error may be temporary e.g. the card was removed.
+void FileInfoParser::ParseFailed(GCodeFileInfo& info) noexcept
+{
+	job->parseState = notParsing;
+	job->file->Close();
+	info = job->info;
+}
+
+// Do some work on the current job. We stop when we have used up the time budget, but we always do at least one step.
+bool FileInfoParser::DoGetFileInfo(const char *filePath, GCodeFileInfo& info, bool quitEarly, uint32_t maxMicros) noexcept
+{
+	if (job->parseState == notParsing)
 	{
 		// See if we can access the file
 		// Webserver may call rr_fileinfo for a directory, check this case here
@@ -52,61 +281,78 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 			return true;
 		}
 
-		fileBeingParsed = MassStorage::OpenFile(filePath, OpenMode::read, 0);
-		if (fileBeingParsed == nullptr)
+		job->file = MassStorage::OpenFile(filePath, OpenMode::read, 0);
+		if (job->file == nullptr)
 		{
 			// Something went wrong - we cannot open it
 			info.isValid = false;
 			return true;
 		}
 
-		// File has been opened, let's start now
-		filenameBeingParsed.copy(filePath);
-		fileOverlapLength = 0;
+		// File has been opened, let's start now. We seek to near the end of the file to find the footer, so build a cluster map first.
+		(void)job->file->EnableFastSeek();
+		job->fileName.copy(filePath);
+		job->overlapLength = 0;
 
 		// Set up the info struct
-		parsedFileInfo.Init();
-		parsedFileInfo.fileSize = fileBeingParsed->Length();
-		parsedFileInfo.lastModifiedTime = MassStorage::GetLastModifiedTime(filePath);
-		parsedFileInfo.isValid = true;
+		job->info.Init();
+		job->info.fileSize = job->file->Length();
+		job->info.lastModifiedTime = MassStorage::GetLastModifiedTime(filePath);
+		job->info.isValid = true;
 
 		// Record some debug values here
 		if (reprap.Debug(modulePrintMonitor))
 		{
-			accumulatedReadTime = accumulatedParseTime = 0;
+			job->accumulatedReadTime = job->accumulatedParseTime = 0;
 			reprap.GetPlatform().MessageF(UsbMessage, "-- Parsing file %s --\n", filePath);
 		}
 
-		// If the file is empty or not a G-Code file, we don't need to parse anything
-		if (fileBeingParsed->Length() == 0 || (!StringEndsWithIgnoreCase(filePath, ".gcode") && !StringEndsWithIgnoreCase(filePath, ".g")
-					&& !StringEndsWithIgnoreCase(filePath, ".gco") && !StringEndsWithIgnoreCase(filePath, ".gc")))
+		// If the file is empty or not a G-Code file, we don't need to parse anything.
+		// If we found it while scanning the G-code directory then store it in the index, so that the scan doesn't pick it again.
+		if (job->file->Length() == 0 || !IsGCodeFileName(filePath))
+		{
+			job->file->Close();
+			job->info.incomplete = false;
+			if (job->inBackground)
+			{
+				index.Store(filePath, job->info);
+			}
+			info = job->info;
+			return true;
+		}
+
+		// If we parsed this file before and it hasn't changed, use the information we found then
+		if (index.Find(filePath, job->info.fileSize, job->info.lastModifiedTime, info))
 		{
-			fileBeingParsed->Close();
-			parsedFileInfo.incomplete = false;
-			info = parsedFileInfo;
+			job->file->Close();
 			return true;
 		}
-		parseState = parsingHeader;
+		job->parseState = parsingHeader;
 	}
 
-	// Getting file information take a few runs. Speed it up when we are not printing by calling it several times.
-	const uint32_t loopStartTime = millis();
+	// Getting file information takes a few runs. Do as many steps as we can within the time budget.
+	// Each job keeps the data that the next chunk must overlap with, because other jobs use the buffer in between.
+	char* const buf = reinterpret_cast<char*>(buf32);
+	memcpy(buf, job->overlap, job->overlapLength);
+	const uint32_t budgetTicks = (uint32_t)(((uint64_t)maxMicros * StepTimer::StepClockRate)/1000000u);
+	const uint32_t loopStartTicks = StepTimer::GetTimerTicks();
+	uint32_t elapsedTicks, stepTicks;
 	do
 	{
-		char* const buf = reinterpret_cast<char*>(buf32);
+		const uint32_t stepStartTicks = StepTimer::GetTimerTicks();
 		size_t sizeToRead, sizeToScan;										// number of bytes we want to read and scan in this go
 
-		switch (parseState)
+		switch (job->parseState)
 		{
 		case parsingHeader:
 			{
 				bool headerInfoComplete = true;
 
 				// Read a chunk from the header. On the first run only process GCODE_READ_SIZE bytes, but use overlap next times.
-				sizeToRead = (size_t)min<FilePosition>(fileBeingParsed->Length() - fileBeingParsed->Position(), GCODE_READ_SIZE);
-				if (fileOverlapLength > 0)
+				sizeToRead = (size_t)min<FilePosition>(job->file->Length() - job->file->Position(), GCODE_READ_SIZE);
+				if (job->overlapLength > 0)
 				{
-					sizeToScan = sizeToRead + fileOverlapLength;
+					sizeToScan = sizeToRead + job->overlapLength;
 				}
 				else
 				{
@@ -114,79 +360,77 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 				}
 
 				uint32_t startTime = millis();
-				const int nbytes = fileBeingParsed->Read(&buf[fileOverlapLength], sizeToRead);
+				const int nbytes = job->file->Read(&buf[job->overlapLength], sizeToRead);
 				if (nbytes != (int)sizeToRead)
 				{
 					reprap.GetPlatform().MessageF(ErrorMessage, "Failed to read header of G-Code file \"%s\"\n", filePath);
-					parseState = notParsing;
-					fileBeingParsed->Close();
-					info = parsedFileInfo;
+					ParseFailed(info);
 					return true;
 				}
 				buf[sizeToScan] = 0;
 
 				// Record performance data
 				uint32_t now = millis();
-				accumulatedReadTime += now - startTime;
+				job->accumulatedReadTime += now - startTime;
 				startTime = now;
 
 				// Search for filament usage (Cura puts it at the beginning of a G-code file)
-				if (parsedFileInfo.numFilaments == 0)
+				if (job->info.numFilaments == 0)
 				{
-					parsedFileInfo.numFilaments = FindFilamentUsed(buf, sizeToScan);
-					headerInfoComplete &= (parsedFileInfo.numFilaments != 0);
+					job->info.numFilaments = FindFilamentUsed(buf, sizeToScan);
+					headerInfoComplete &= (job->info.numFilaments != 0);
 				}
 
 				// Look for first layer height
-				if (parsedFileInfo.firstLayerHeight == 0.0)
+				if (job->info.firstLayerHeight == 0.0)
 				{
 					headerInfoComplete &= FindFirstLayerHeight(buf, sizeToScan);
 				}
 
 				// Look for layer height
-				if (parsedFileInfo.layerHeight == 0.0)
+				if (job->info.layerHeight == 0.0)
 				{
 					headerInfoComplete &= FindLayerHeight(buf, sizeToScan);
 				}
 
 				// Look for slicer program
-				if (parsedFileInfo.generatedBy.IsEmpty())
+				if (job->info.generatedBy.IsEmpty())
 				{
 					headerInfoComplete &= FindSlicerInfo(buf, sizeToScan);
 				}
 
 				// Look for print time
-				if (parsedFileInfo.printTime == 0)
+				if (job->info.printTime == 0)
 				{
 					headerInfoComplete &= FindPrintTime(buf, sizeToScan);
 				}
 
 				// Keep track of the time stats
-				accumulatedParseTime += millis() - startTime;
+				job->accumulatedParseTime += millis() - startTime;
 
 				// Can we proceed to the footer? Don't scan more than the first 4KB of the file
-				FilePosition pos = fileBeingParsed->Position();
-				if (headerInfoComplete || pos >= GCODE_HEADER_SIZE || pos == fileBeingParsed->Length())
+				FilePosition pos = job->file->Position();
+				if (headerInfoComplete || pos >= GCODE_HEADER_SIZE || pos == job->file->Length())
 				{
 					// Yes - see if we need to output some debug info
 					if (reprap.Debug(modulePrintMonitor))
 					{
 						reprap.GetPlatform().MessageF(UsbMessage, "Header complete, processed %lu bytes, read time %.3fs, parse time %.3fs\n",
-											fileBeingParsed->Position(), (double)((float)accumulatedReadTime/1000.0), (double)((float)accumulatedParseTime/1000.0));
+											job->file->Position(), (double)((float)job->accumulatedReadTime/1000.0), (double)((float)job->accumulatedParseTime/1000.0));
 					}
 
 					// Go to the last chunk and proceed from there on
-					const FilePosition seekFromEnd = ((fileBeingParsed->Length() - 1) % GCODE_READ_SIZE) + 1;
-					nextSeekPos = fileBeingParsed->Length() - seekFromEnd;
-					accumulatedSeekTime = accumulatedReadTime = accumulatedParseTime = 0;
-					fileOverlapLength = 0;
-					parseState = seeking;
+					const FilePosition seekFromEnd = ((job->file->Length() - 1) % GCODE_READ_SIZE) + 1;
+					job->nextSeekPos = job->file->Length() - seekFromEnd;
+					job->accumulatedSeekTime = job->accumulatedReadTime = job->accumulatedParseTime = 0;
+					job->overlapLength = 0;
+					job->parseState = seeking;
 				}
 				else
 				{
 					// No - copy the last chunk of the buffer for overlapping search
-					fileOverlapLength = min<size_t>(sizeToRead, GCODE_OVERLAP_SIZE);
-					memcpy(buf, &buf[sizeToRead - fileOverlapLength], fileOverlapLength);
+					job->overlapLength = min<size_t>(sizeToRead, GCODE_OVERLAP_SIZE);
+					memcpy(buf, &buf[sizeToRead - job->overlapLength], job->overlapLength);
 				}
 			}
 			break;
@@ -194,9 +438,9 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 		case seeking:
 			// Seeking into a large file can take a long time using the FAT file system, so do it in stages
 			{
-				FilePosition currentPos = fileBeingParsed->Position();
-				const uint32_t clsize = fileBeingParsed->ClusterSize();
-				if (currentPos/clsize > nextSeekPos/clsize)
+				FilePosition currentPos = job->file->Position();
+				const uint32_t clsize = job->file->ClusterSize();
+				if (currentPos/clsize > job->nextSeekPos/clsize)
 				{
 					// Seeking backwards over a cluster boundary, so in practice the seek will start from the start of the file
 					currentPos = 0;
@@ -204,22 +448,20 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 
 				// Seek at most 512 clusters at a time
 				const FilePosition maxSeekDistance = 512 * (FilePosition)clsize;
-				const bool doFullSeek = (nextSeekPos <= currentPos + maxSeekDistance);
-				const FilePosition thisSeekPos = (doFullSeek) ? nextSeekPos : currentPos + maxSeekDistance;
+				const bool doFullSeek = (job->nextSeekPos <= currentPos + maxSeekDistance);
+				const FilePosition thisSeekPos = (doFullSeek) ? job->nextSeekPos : currentPos + maxSeekDistance;
 
 				const uint32_t startTime = millis();
-				if (!fileBeingParsed->Seek(thisSeekPos))
+				if (!job->file->Seek(thisSeekPos))
 				{
 					reprap.GetPlatform().MessageF(ErrorMessage, "Could not seek from end of file \"%s\"\n", filePath);
-					parseState = notParsing;
-					fileBeingParsed->Close();
-					info = parsedFileInfo;
+					ParseFailed(info);
 					return true;
 				}
-				accumulatedSeekTime += millis() - startTime;
+				job->accumulatedSeekTime += millis() - startTime;
 				if (doFullSeek)
 				{
-					parseState = parsingFooter;
+					job->parseState = parsingFooter;
 				}
 			}
 			break;
@@ -227,11 +469,11 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 		case parsingFooter:
 			{
 				// Processing the footer. See how many bytes we need to read and if we can reuse the overlap
-				sizeToRead = (size_t)min<FilePosition>(fileBeingParsed->Length() - nextSeekPos, GCODE_READ_SIZE);
-				if (fileOverlapLength > 0)
+				sizeToRead = (size_t)min<FilePosition>(job->file->Length() - job->nextSeekPos, GCODE_READ_SIZE);
+				if (job->overlapLength > 0)
 				{
-					memcpy(&buf[sizeToRead], buf, fileOverlapLength);
-					sizeToScan = sizeToRead + fileOverlapLength;
+					memcpy(&buf[sizeToRead], buf, job->overlapLength);
+					sizeToScan = sizeToRead + job->overlapLength;
 				}
 				else
 				{
@@ -240,36 +482,34 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 
 				// Read another chunk from the footer
 				uint32_t startTime = millis();
-				int nbytes = fileBeingParsed->Read(buf, sizeToRead);
+				int nbytes = job->file->Read(buf, sizeToRead);
 				if (nbytes != (int)sizeToRead)
 				{
 					reprap.GetPlatform().MessageF(ErrorMessage, "Failed to read footer from G-Code file \"%s\"\n", filePath);
-					parseState = notParsing;
-					fileBeingParsed->Close();
-					info = parsedFileInfo;
+					ParseFailed(info);
 					return true;
 				}
 				buf[sizeToScan] = 0;
 
 				// Record performance data
 				uint32_t now = millis();
-				accumulatedReadTime += now - startTime;
+				job->accumulatedReadTime += now - startTime;
 				startTime = now;
 
 				bool footerInfoComplete = true;
 
 				// Search for filament used
-				if (parsedFileInfo.numFilaments == 0)
+				if (job->info.numFilaments == 0)
 				{
-					parsedFileInfo.numFilaments = FindFilamentUsed(buf, sizeToScan);
-					if (parsedFileInfo.numFilaments == 0)
+					job->info.numFilaments = FindFilamentUsed(buf, sizeToScan);
+					if (job->info.numFilaments == 0)
 					{
 						footerInfoComplete = false;
 					}
 				}
 
 				// Search for layer height
-				if (parsedFileInfo.layerHeight == 0.0)
+				if (job->info.layerHeight == 0.0)
 				{
 					if (!FindLayerHeight(buf, sizeToScan))
 					{
@@ -278,7 +518,7 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 				}
 
 				// Search for object height
-				if (parsedFileInfo.objectHeight == 0.0)
+				if (job->info.objectHeight == 0.0)
 				{
 					if (!FindHeight(buf, sizeToScan))
 					{
@@ -287,64 +527,69 @@ bool FileInfoParser::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool
 				}
 
 				// Look for print time
-				if (parsedFileInfo.printTime == 0)
+				if (job->info.printTime == 0)
 				{
-					if (!FindPrintTime(buf, sizeToScan) && fileBeingParsed->Length() - nextSeekPos <= GcodeFooterPrintTimeSearchSize)
+					if (!FindPrintTime(buf, sizeToScan) && job->file->Length() - job->nextSeekPos <= GcodeFooterPrintTimeSearchSize)
 					{
 						footerInfoComplete = false;
 					}
 				}
 
 				// Look for simulated print time. It will always be right at the end of the file, so don't look too far back
-				if (parsedFileInfo.simulatedTime == 0)
+				if (job->info.simulatedTime == 0)
 				{
-					if (!FindSimulatedTime(buf, sizeToScan) && fileBeingParsed->Length() - nextSeekPos <= GcodeFooterPrintTimeSearchSize)
+					if (!FindSimulatedTime(buf, sizeToScan) && job->file->Length() - job->nextSeekPos <= GcodeFooterPrintTimeSearchSize)
 					{
 						footerInfoComplete = false;
 					}
 				}
 
 				// Keep track of the time stats
-				accumulatedParseTime += millis() - startTime;
+				job->accumulatedParseTime += millis() - startTime;
 
 				// If we've collected all details, scanned the last 192K of the file or if we cannot go any further, stop here.
-				if (footerInfoComplete || nextSeekPos == 0 || fileBeingParsed->Length() - nextSeekPos >= GCODE_FOOTER_SIZE)
+				if (footerInfoComplete || job->nextSeekPos == 0 || job->file->Length() - job->nextSeekPos >= GCODE_FOOTER_SIZE)
 				{
 					if (reprap.Debug(modulePrintMonitor))
 					{
 						reprap.GetPlatform().MessageF(UsbMessage, "Footer complete, processed %lu bytes, read time %.3fs, parse time %.3fs, seek time %.3fs\n",
-											fileBeingParsed->Length() - fileBeingParsed->Position() + GCODE_READ_SIZE,
-											(double)((float)accumulatedReadTime/1000.0), (double)((float)accumulatedParseTime/1000.0), (double)((float)accumulatedSeekTime/1000.0));
+											job->file->Length() - job->file->Position() + GCODE_READ_SIZE,
+											(double)((float)job->accumulatedReadTime/1000.0), (double)((float)job->accumulatedParseTime/1000.0), (double)((float)job->accumulatedSeekTime/1000.0));
 					}
-					parseState = notParsing;
-					fileBeingParsed->Close();
-					parsedFileInfo.incomplete = false;
-					info = parsedFileInfo;
+					job->parseState = notParsing;
+					job->file->Close();
+					job->info.incomplete = false;
+					index.Store(job->fileName.c_str(), job->info);
+					info = job->info;
 					return true;
 				}
 
 				// Else go back further
-				fileOverlapLength = (size_t)min<FilePosition>(sizeToScan, GCODE_OVERLAP_SIZE);
-				nextSeekPos = (nextSeekPos <= GCODE_READ_SIZE) ? 0 : nextSeekPos - GCODE_READ_SIZE;
-				parseState = seeking;
+				job->overlapLength = (size_t)min<FilePosition>(sizeToScan, GCODE_OVERLAP_SIZE);
+				job->nextSeekPos = (job->nextSeekPos <= GCODE_READ_SIZE) ? 0 : job->nextSeekPos - GCODE_READ_SIZE;
+				job->parseState = seeking;
 			}
 			break;
 
 		default:	// should not get here
-			parsedFileInfo.incomplete = false;
-			fileBeingParsed->Close();
-			info = parsedFileInfo;
-			parseState = notParsing;
+			job->info.incomplete = false;
+			job->file->Close();
+			info = job->info;
+			job->parseState = notParsing;
 			return true;
 		}
-		lastFileParseTime = millis();
-	} while (!reprap.GetPrintMonitor().IsPrinting() && lastFileParseTime - loopStartTime < MAX_FILEINFO_PROCESS_TIME);
+		job->lastParseTime = millis();
+		const uint32_t now = StepTimer::GetTimerTicks();
+		stepTicks = now - stepStartTicks;
+		elapsedTicks = now - loopStartTicks;
+	} while (elapsedTicks + stepTicks <= budgetTicks);				// don't start another step if it would probably take us over budget
 
+	memcpy(job->overlap, buf, job->overlapLength);
 	if (quitEarly)
 	{
-		info = parsedFileInfo;				// note that the 'incomplete' flag is still set
-		fileBeingParsed->Close();
-		parseState = notParsing;
+		info = job->info;				// note that the 'incomplete' flag is still set
+		job->file->Close();
+		job->parseState = notParsing;
 		return true;
 	}
 	return false;
@@ -358,7 +603,7 @@ bool FileInfoParser::FindFirstLayerHeight(const char* buf, size_t len) noexcept
 		// Don't start if the buffer is not big enough
 		return false;
 	}
-	parsedFileInfo.firstLayerHeight = 0.0;
+	job->info.firstLayerHeight = 0.0;
 
 	bool inComment = false, inRelativeMode = false, foundHeight = false;
 	for(size_t i = 0; i < len - 4; i++)
@@ -395,9 +640,9 @@ bool FileInfoParser::FindFirstLayerHeight(const char* buf, size_t len) noexcept
 					{
 						//debugPrintf("Found at offset %u text: %.100s\n", i, &buf[i + 1]);
 						const float flHeight = SafeStrtof(&buf[i + 1], nullptr);
-						if ((parsedFileInfo.firstLayerHeight == 0.0 || flHeight < parsedFileInfo.firstLayerHeight) && (flHeight <= reprap.GetPlatform().GetNozzleDiameter() * 3.0))
+						if ((job->info.firstLayerHeight == 0.0 || flHeight < job->info.firstLayerHeight) && (flHeight <= reprap.GetPlatform().GetNozzleDiameter() * 3.0))
 						{
-							parsedFileInfo.firstLayerHeight = flHeight;				// Only report first Z height if it's somewhat reasonable
+							job->info.firstLayerHeight = flHeight;				// Only report first Z height if it's somewhat reasonable
 							foundHeight = true;
 							// NB: Don't stop here, because some slicers generate two Z moves at the beginning
 						}
@@ -490,7 +735,7 @@ bool FileInfoParser::FindHeight(const char* buf, size_t len) noexcept
 								float objectHeight = SafeStrtof(zpos, nullptr);
 								if (!isnan(objectHeight) && !isinf(objectHeight))
 								{
-									parsedFileInfo.objectHeight = objectHeight;
+									job->info.objectHeight = objectHeight;
 									foundHeight = true;
 								}
 							}
@@ -519,7 +764,7 @@ bool FileInfoParser::FindHeight(const char* buf, size_t len) noexcept
 				float objectHeight = SafeStrtof(buf + sizeof(kisslicerHeightString)/sizeof(char) - 1, nullptr);
 				if (!isnan(objectHeight) && !isinf(objectHeight))
 				{
-					parsedFileInfo.objectHeight = objectHeight;
+					job->info.objectHeight = objectHeight;
 					return true;
 				}
 			}
@@ -566,7 +811,7 @@ bool FileInfoParser::FindLayerHeight(const char *buf, size_t len) noexcept
 					const float val = SafeStrtof(pos, &tailPtr);
 					if (tailPtr != pos && !isnan(val) && !isinf(val))	// if we found and converted a number
 					{
-						parsedFileInfo.layerHeight = val;
+						job->info.layerHeight = val;
 						return true;
 					}
 				}
@@ -619,10 +864,10 @@ bool FileInfoParser::FindSlicerInfo(const char* buf, size_t len) noexcept
 			break;
 		}
 
-		parsedFileInfo.generatedBy.copy(introString);
+		job->info.generatedBy.copy(introString);
 		while (*pos >= ' ')
 		{
-			parsedFileInfo.generatedBy.cat(*pos++);
+			job->info.generatedBy.cat(*pos++);
 		}
 		return true;
 	}
@@ -653,7 +898,7 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* buf, size_t len) noexc
 			p = q;
 			if (!isnan(filamentLength) && !isinf(filamentLength))
 			{
-				parsedFileInfo.filamentNeeded[filamentsFound] = filamentLength;
+				job->info.filamentNeeded[filamentsFound] = filamentLength;
 				if (*p == 'm')
 				{
 					++p;
@@ -663,7 +908,7 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* buf, size_t len) noexc
 					}
 					else
 					{
-						parsedFileInfo.filamentNeeded[filamentsFound] *= 1000.0;		// Cura outputs filament used in metres not mm
+						job->info.filamentNeeded[filamentsFound] *= 1000.0;		// Cura outputs filament used in metres not mm
 					}
 				}
 				++filamentsFound;
@@ -695,7 +940,7 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* buf, size_t len) noexc
 				float filamentLength = SafeStrtof(p, nullptr);
 				if (!isnan(filamentLength) && !isinf(filamentLength))
 				{
-					parsedFileInfo.filamentNeeded[filamentsFound] = filamentLength;
+					job->info.filamentNeeded[filamentsFound] = filamentLength;
 					++filamentsFound;
 				}
 			}
@@ -719,7 +964,7 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* buf, size_t len) noexc
 				float filamentLength = SafeStrtof(p, nullptr);
 				if (!isnan(filamentLength) && !isinf(filamentLength))
 				{
-					parsedFileInfo.filamentNeeded[filamentsFound] = filamentLength;
+					job->info.filamentNeeded[filamentsFound] = filamentLength;
 					++filamentsFound;
 				}
 			}
@@ -752,7 +997,7 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* buf, size_t len) noexc
 				float filamentLength = SafeStrtof(p, nullptr);
 				if (!isnan(filamentLength) && !isinf(filamentLength))
 				{
-					parsedFileInfo.filamentNeeded[filamentsFound] = filamentLength;
+					job->info.filamentNeeded[filamentsFound] = filamentLength;
 					++filamentsFound;
 				}
 			}
@@ -769,7 +1014,7 @@ unsigned int FileInfoParser::FindFilamentUsed(const char* buf, size_t len) noexc
 			const float filamentCMM = SafeStrtof(p + strlen(filamentVolumeStr), nullptr) * 1000.0;
 			if (!isnan(filamentCMM) && !isinf(filamentCMM))
 			{
-				parsedFileInfo.filamentNeeded[filamentsFound++] = filamentCMM / (Pi * fsquare(reprap.GetPlatform().GetFilamentWidth() / 2.0));
+				job->info.filamentNeeded[filamentsFound++] = filamentCMM / (Pi * fsquare(reprap.GetPlatform().GetFilamentWidth() / 2.0));
 			}
 		}
 	}
@@ -845,7 +1090,7 @@ bool FileInfoParser::FindPrintTime(const char* buf, size_t len) noexcept
 					secs = SafeStrtof(pos, &pos);
 				}
 			}
-			parsedFileInfo.printTime = lrintf((hours * 60.0 + minutes) * 60.0 + secs);
+			job->info.printTime = lrintf((hours * 60.0 + minutes) * 60.0 + secs);
 			return true;
 		}
 	}
@@ -867,7 +1112,7 @@ bool FileInfoParser::FindSimulatedTime(const char* buf, size_t len) noexcept
 		const uint32_t secs = StrToU32(pos, &pos);
 		if (q != pos)
 		{
-			parsedFileInfo.simulatedTime = secs;
+			job->info.simulatedTime = secs;
 			return true;
 		}
 	}
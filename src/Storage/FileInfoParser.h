@@ -14,6 +14,8 @@
 #if HAS_MASS_STORAGE
 
 #include "RTOSIface/RTOSIface.h"
+#include "Libraries/Fatfs/ff.h"
+#include "FileInfoIndex.h"
 
 const FilePosition GCODE_HEADER_SIZE = 20000uL;		// How many bytes to read from the header - I (DC) have a Kisslicer file with a layer height comment 14Kb from the start
 const FilePosition GCODE_FOOTER_SIZE = 400000uL;	// How many bytes to read from the footer
@@ -29,7 +31,10 @@ const size_t GcodeFooterPrintTimeSearchSize = 4096;	// How much of the end of th
 const size_t GCODE_OVERLAP_SIZE = 100;				// Size of the overlapping buffer for searching (must be a multiple of 4)
 
 const uint32_t MAX_FILEINFO_PROCESS_TIME = 200;		// Maximum time to spend polling for file info in each call
+const uint32_t MaxFileInfoMicrosWhenPrinting = 2000;	// Maximum time to spend parsing file info in each call while we are printing. We always read at least one chunk.
 const uint32_t MaxFileParseInterval = 4000;			// Maximum interval between repeat requests to parse a file
+const uint32_t FileInfoIndexScanInterval = 60000;	// How often we look for new G-code files to add to the file info index when we are not printing
+const unsigned int MaxFilesExaminedPerSpin = 8;		// How many directory entries we look at in each call to FileInfoParser::Spin when looking for files to add to the index
 
 enum FileParseState
 {
@@ -39,6 +44,29 @@ enum FileParseState
 	parsingFooter
 };
 
+#if defined(__LPC17xx__)
+const size_t NumFileInfoParseJobs = 2;				// How many files we can parse at the same time
+#else
+const size_t NumFileInfoParseJobs = 4;				// How many files we can parse at the same time
+#endif
+
+// The state of parsing one file
+struct FileParseJob
+{
+	unsigned int GetProgress() const noexcept;
+
+	FileParseState parseState;
+	bool inBackground;								// true if the file was chosen by FileInfoParser::Spin, not requested by a client
+	String<MaxFilenameLength> fileName;
+	FileStore *file;
+	FilePosition nextSeekPos;
+	GCodeFileInfo info;
+	uint32_t lastParseTime;
+	uint32_t accumulatedParseTime, accumulatedReadTime, accumulatedSeekTime;
+	size_t overlapLength;
+	char overlap[GCODE_OVERLAP_SIZE];				// the end of the last chunk we read, which we search together with the next chunk
+};
+
 class FileInfoParser
 {
 public:
@@ -47,9 +75,20 @@ public:
 	// The following method needs to be called until it returns true - this may take a few runs
 	bool GetFileInfo(const char *filePath, GCodeFileInfo& info, bool quitEarly) noexcept;
 
+	int GetProgress(const char *filePath) noexcept;			// Return the percentage of the file that we have parsed, or -1 if we are not parsing it
+	void Spin() noexcept;									// Add G-code files to the file info index in the background
+	void InvalidateIndex() noexcept;						// Called when the SD card is unmounted
+	void Diagnostics(MessageType mtype) noexcept;
+
 	static constexpr const char* SimulatedTimeString = "\n; Simulated print time";	// used by FileInfoParser and MassStorage
 
 private:
+	FileParseJob *FindJob(const char *filePath) noexcept;
+	bool DoGetFileInfo(const char *filePath, GCodeFileInfo& info, bool quitEarly, uint32_t maxMicros) noexcept;
+	bool FindFileToIndex(const StringRef& filePath) noexcept;
+	void CheckInvalidated() noexcept;
+	void ParseFailed(GCodeFileInfo& info) noexcept;
+	static bool IsGCodeFileName(const char *filePath) noexcept;
 
 	// G-Code parser methods
 	bool FindHeight(const char* buf, size_t len) noexcept;
@@ -60,17 +99,19 @@ private:
 	bool FindSimulatedTime(const char* buf, size_t len) noexcept;
 	unsigned int FindFilamentUsed(const char* buf, size_t len) noexcept;
 
-	// We parse G-Code files in multiple stages. These variables hold the required information
+	// We parse G-Code files in multiple stages, and we can parse several files at once. Each job holds the state of parsing one file.
 	Mutex parserMutex;
 
-	FileParseState parseState;
-	String<MaxFilenameLength> filenameBeingParsed;
-	FileStore *fileBeingParsed;
-	FilePosition nextSeekPos;
-	GCodeFileInfo parsedFileInfo;
-	uint32_t lastFileParseTime;
-	uint32_t accumulatedParseTime, accumulatedReadTime, accumulatedSeekTime;
-	size_t fileOverlapLength;
+	FileParseJob jobs[NumFileInfoParseJobs];
+	FileParseJob *job;										// the job we are working on
+
+	FileInfoIndex index;
+	uint32_t lastIndexScanTime;
+	DIR indexDir;											// the G-code directory that we are scanning for files to add to the index
+	bool indexDirOpen;
+	bool indexScanComplete;
+	volatile bool indexInvalidated;							// set when the SD card is unmounted, cleared when we have acted on it
+	uint32_t maxCallMicros;									// the longest time that a client has spent in GetFileInfo
 
 	// We used to allocate the following buffer on the stack; but now that this is called by more than one task
 	// it is more economical to allocate it permanently because that lets us use smaller stacks.
@@ -477,16 +477,15 @@ bool FileStore::IsSameFile(const FIL& otherFile) const noexcept
 	return file.obj.fs == otherFile.obj.fs && file.dir_sect == otherFile.dir_sect && file.dir_ptr == otherFile.dir_ptr;
 }
 
-#if 0	// not currently used
-
-// Provide a cluster map for fast seeking. Needs _USE_FASTSEEK defined as 1 in conf_fatfs to make any difference.
+// Provide a cluster map for fast seeking. Needs FF_USE_FASTSEEK defined as 1 in ffconf.h to make any difference.
 // The first element of the table must be set to the total number of 32-bit entries in the table before calling this.
+// A file with a cluster map can't be extended, so this should only be used on files that are open for reading.
 bool FileStore::SetClusterMap(uint32_t tbl[]) noexcept
 {
 	switch (usageMode)
 	{
 	case FileUseMode::free:
-		INTERNAL_ERROR;
+		REPORT_INTERNAL_ERROR;
 		return false;
 
 	case FileUseMode::readOnly:
@@ -504,7 +503,24 @@ bool FileStore::SetClusterMap(uint32_t tbl[]) noexcept
 	}
 }
 
-#endif
+// Build a cluster map for a file that is open for reading, so that seeks within it take constant time instead of following the FAT chain from the start of the file.
+// This walks the chain once, so it is worth doing for print files and files that we seek around in, but not for files that we read once from the start.
+// Return true if successful. If the file has too many fragments to fit in the map, seeking works as before.
+bool FileStore::EnableFastSeek() noexcept
+{
+	if (usageMode != FileUseMode::readOnly)
+	{
+		return false;
+	}
+
+	clusterMap[0] = ARRAY_SIZE(clusterMap);
+	if (SetClusterMap(clusterMap))
+	{
+		return true;
+	}
+	file.cltbl = nullptr;
+	return false;
+}
 
 #endif
 
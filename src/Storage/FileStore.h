@@ -66,9 +66,8 @@ public:
 	bool IsCloseRequested() const noexcept { return closeRequested; }
 	bool IsFree() const noexcept { return usageMode == FileUseMode::free; }
 
-#if 0	// not currently used
 	bool SetClusterMap(uint32_t[]) noexcept;					// Provide a cluster map for fast seeking
-#endif
+	bool EnableFastSeek() noexcept;								// Build our own cluster map so that seeking doesn't need to follow the FAT chain
 
 private:
 	void Init() noexcept;
@@ -82,6 +81,7 @@ private:
 	FileUseMode usageMode;
 
 	CRC32 crc;
+	uint32_t clusterMap[FileClusterMapSize];
 
 	static uint32_t longestWriteTime;
 };
@@ -136,6 +136,10 @@ static unsigned int InternalUnmount(size_t card, bool doClose) noexcept
 	memset(&inf.fileSystem, 0, sizeof(inf.fileSystem));
 	sd_mmc_unmount(card);
 	inf.isMounted = false;
+	if (card == 0)
+	{
+		infoParser.InvalidateIndex();
+	}
 	reprap.VolumesUpdated();
 	return invalidated;
 }
@@ -371,6 +375,43 @@ void MassStorage::AbandonFindNext() noexcept
 	}
 }
 
+// Open a directory for a caller that reads it a few entries at a time, e.g. a background task that may be suspended between reads.
+// The caller owns the DIR object and no mutex is held between calls, so FindFirst/FindNext can be used in the meantime.
+// We don't use file locking, so a DIR object doesn't need to be closed. If the volume is unmounted then reading it fails.
+bool MassStorage::OpenDirectory(DIR& dir, const char *directory) noexcept
+{
+	// Remove any trailing '/' from the directory name, it sometimes (but not always) confuses f_opendir
+	String<MaxFilenameLength> loc;
+	loc.copy(directory);
+	const size_t len = loc.strlen();
+	if (len != 0 && (loc[len - 1] == '/' || loc[len - 1] == '\\'))
+	{
+		loc.Truncate(len - 1);
+	}
+	return f_opendir(&dir, loc.c_str()) == FR_OK;
+}
+
+// Read the next entry of a directory opened by OpenDirectory, skipping the "." and ".." entries
+bool MassStorage::ReadDirectory(DIR& dir, FileInfo &file_info) noexcept
+{
+	FILINFO entry;
+	for (;;)
+	{
+		if (f_readdir(&dir, &entry) != FR_OK || entry.fname[0] == 0)
+		{
+			return false;
+		}
+		if (!StringEqualsIgnoreCase(entry.fname, ".") && !StringEqualsIgnoreCase(entry.fname, ".."))
+		{
+			file_info.isDirectory = (entry.fattrib & AM_DIR);
+			file_info.fileName.copy(entry.fname);
+			file_info.size = entry.fsize;
+			file_info.lastModified = ConvertTimeStamp(entry.fdate, entry.ftime);
+			return true;
+		}
+	}
+}
+
 // Month names. The first entry is used for invalid month numbers.
 static const char *monthNames[13] = { "???", "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
 
@@ -817,6 +858,12 @@ void MassStorage::Spin() noexcept
 			}
 		}
 	}
+
+	// Add any new G-code files to the file info index
+	if (info[0].isMounted)
+	{
+		infoParser.Spin();
+	}
 }
 
 // Append the simulated printing time to the end of the file
@@ -921,6 +968,11 @@ bool MassStorage::GetFileInfo(const char *filePath, GCodeFileInfo& info, bool qu
 	return infoParser.GetFileInfo(filePath, info, quitEarly);
 }
 
+int MassStorage::GetFileInfoProgress(const char *filePath) noexcept
+{
+	return infoParser.GetProgress(filePath);
+}
+
 void MassStorage::Diagnostics(MessageType mtype) noexcept
 {
 	Platform& platform = reprap.GetPlatform();
@@ -939,6 +991,8 @@ void MassStorage::Diagnostics(MessageType mtype) noexcept
 	// Show the longest SD card write time
 	platform.MessageF(mtype, "SD card longest read time %.1fms, write time %.1fms, max retries %u\n",
 								(double)DiskioGetAndClearLongestReadTime(), (double)DiskioGetAndClearLongestWriteTime(), DiskioGetAndClearMaxRetryCount());
+
+	infoParser.Diagnostics(mtype);
 }
 
 # if SUPPORT_OBJECT_MODEL
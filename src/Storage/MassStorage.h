@@ -34,6 +34,8 @@ namespace MassStorage
 	bool FindFirst(const char *directory, FileInfo &file_info) noexcept;
 	bool FindNext(FileInfo &file_info) noexcept;
 	void AbandonFindNext() noexcept;
+	bool OpenDirectory(DIR& dir, const char *directory) noexcept;							// open a directory that the caller reads a few entries at a time
+	bool ReadDirectory(DIR& dir, FileInfo &file_info) noexcept;								// read the next entry, returning false at the end of the directory or on error
 	bool Delete(const char* filePath, bool messageIfFailed) noexcept;
 	bool EnsurePath(const char* filePath, bool messageIfFailed) noexcept;
 	bool MakeDirectory(const char *directory, bool messageIfFailed) noexcept;
@@ -55,6 +57,7 @@ namespace MassStorage
 	void Spin() noexcept;
 	const Mutex& GetVolumeMutex(size_t vol) noexcept;
 	bool GetFileInfo(const char *filePath, GCodeFileInfo& info, bool quitEarly) noexcept;
+	int GetFileInfoProgress(const char *filePath) noexcept;									// Return the percentage of the file that we have parsed, or -1 if we are not parsing it
 	void RecordSimulationTime(const char *printingFilePath, uint32_t simSeconds) noexcept;	// Append the simulated printing time to the end of the file
 	FileWriteBuffer *AllocateWriteBuffer() noexcept;
 	void ReleaseWriteBuffer(FileWriteBuffer *buffer) noexcept;